@@ -4,7 +4,7 @@
 	#include <stdint.h>
 	#include <pthread.h>
 
-	enum cont_events { cnt_add, cnt_remove, cnt_pending };
+	enum cont_events { cnt_add, cnt_remove, cnt_pending, cnt_create };
 
 	typedef struct cont_event {
 		int event;			// enum cont_events
@@ -14,8 +14,13 @@
 		uint64_t timenano;	// timestamp in nanoseconds
 	} contevent_t;
 
-	extern pthread_mutex_t containerMutex; // data access mutex
-	extern contevent_t * containerEvent; // data
+	#define DLINK_RINGSZ	256	// container event queue size, power of 2
+
+	extern _Atomic uint64_t dlink_overflow; // pushes refused, queue full
+
+	int dlink_push(const contevent_t * evnt);	// any thread
+	int dlink_pop(contevent_t * evnts, int max);	// update thread only
+	int dlink_cpuset(const char * id, const char * cpus); // Engine API only
 
 	void *dlink_thread_watch(void *arg);
 
@@ -41,6 +41,7 @@
 	int string_to_policy(const char *policy_name, uint32_t *policy);
 
 	uint32_t string_to_affinity(const char *str);
+	uint32_t string_to_admission(const char *str);
 
 	int get_status_flags(uint64_t status, char * buff, int size);
 #endif
@@ -29,6 +29,7 @@
 	// masks for the status of configurations, PID/CNT/IMG
 	#define MSK_STATCFIX		0x1	// CPU affinity configuration is fixed
 	#define	MSK_STATCCRT		0x2 // Configuration created from Runtime
+	#define MSK_STATCPRE		0x4	// Container CPU-set placed at creation
 
 	#define MSK_STATSHAT		0x10// shared attribute configuration
 	#define MSK_STATSHRC		0x20// shared resource configuration
@@ -39,6 +40,7 @@
 
 	// masks fot the status of a resource (resTracer_t)
 	#define MSK_STATHRMC		0x1	// resource allocation periods are harmonic
+	#define MSK_STATTUPD		0x2	// task accounting outdated, recompute from tasks
 
 	// masks for dry-run selective environment preparation
 	#define MSK_DRYNOSMTOFF		0x1 // Do not disable SMT
@@ -115,6 +117,14 @@
 		SM_DYNMCBIN		// use Monte-Carlo bin allocation style algorithm
 	};
 
+	// definition of admission tests for task placement
+	enum adm_mode {
+		ADM_ULIMIT = 0x0,	// utilization bound and period score only (default)
+		ADM_DEMAND = 0x1,	// + EDF processor-demand test for SCHED_DEADLINE
+		ADM_RTA = 0x2,		// + fixed-priority response-time analysis for FIFO/RR
+		ADM_EXACT = 0x3		// both of the above
+	};
+
 	typedef struct sched_rscs { // resources 
 		int32_t affinity; // exclusive CPU-numbers
 		struct bitmask * affinity_mask;	// computed affinity mask
@@ -188,6 +198,8 @@
 		int 	 status;		// generic status info
 		uint64_t usedPeriod;	// amount of CPU-time left..
 		uint64_t basePeriod;	// if a common period is set, or least common multiplier
+		struct sched_pid * tasks;	// tasks accounted in U, linked by mon.tnext
+		struct sched_pid ** ttail;	// link of the last task, NULL = &tasks
 		// used during runtime for stats
 		float	 Umin;			// utilization factor
 		float	 Uavg;			// utilization factor
@@ -231,6 +243,10 @@
 		struct bitmask * assigned_mask;	// computed assignment mask
 		uint64_t resched;		// number of rescheduling times
 		uint64_t resample;		// number of resampling times
+
+		// resource tracer accounting
+		struct resTracer * trc;	// tracer the task is accounted in, NULL = none
+		struct sched_pid * tnext;	// next task of the same tracer
 	} nodemon_t;
 
 	typedef struct sched_pid { // PID management and monitoring info
@@ -276,6 +292,7 @@
 		int runtime;				// total orchestrator runtime, 0 is infinite
 		int psigscan;				// scan for child threads, -n option only
 		int trackpids;				// keep track of left pids, do not delete from list
+		int procevents;				// detect new PIDs from kernel proc connector events, too
 		int dryrun;					// test only, no changes to environment
 		int blindrun;				// blind run of orchestrator, avoid settings (extension of dryrun)
 		int lock_pages;				// memory lock on startup
@@ -295,8 +312,12 @@
 
 		// runtime settings
 		int ftrace; 				// enable Kernel ftrace for run-time statistics
+		int ftrace_rdrs;			// ftrace reader pool size on system CPUs, 0 = one thread per CPU
+		char * trace_rec;			// directory to record raw trace pages to, NULL = off
+		char * trace_play;			// directory of a recorded trace to replay, NULL = live
 		enum det_mode use_cgroup;	// identify processes via CGroup
 		enum sched_mode sched_mode;	// scheduling control mode
+		enum adm_mode admission;	// admission test for task placement
 		double ptresh;				// probability threshold for resource switching
 
 	} prgset_t;
@@ -321,4 +342,16 @@
 	// separate, as they set init values and free subs
 	void node_push(node_t ** head);
 	void node_pop(node_t ** head);
+	void node_slabFree();
+
+	// PID -> node lookup index, O(1) for event handlers - MUTEX must be acquired
+	void node_idxAdd(node_t * node);
+	void node_idxDel(node_t * node);
+	node_t * node_idxGet(pid_t pid);
+	uint32_t node_idxGen();
+	void node_idxFree();
+
+	// task lists of the resource tracers - MUTEX must be acquired
+	void node_trcAdd(resTracer_t * trc, node_t * node);
+	void node_trcDel(node_t * node);
 #endif
@@ -51,6 +51,8 @@ int runstats_mdlUpb(stat_param * x, double a,		// compute upper bound b that obt
 int runstats_cdfCreate(stat_hist **h, stat_cdf **c);// transfer histogram data to CDF and resort histogram
 double runstats_cdfSample(const stat_cdf * c,
 		double r);									// compute time from CDF value
+int runstats_cdfCopy(const stat_cdf * c,
+		stat_cdf ** d);								// copy CDF to destination
 void runstats_cdfFree(stat_cdf ** c);				// CDF free
 
 double runstats_gaussian(const double a, const double b,
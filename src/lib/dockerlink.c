@@ -1,17 +1,21 @@
 #include "dockerlink.h"
 
 #include <stdbool.h>		// for bool definition and operation
-#include <json-c/json.h>	// libjson-c for parsing
+#include <ctype.h>			// character classes for the event tokener
 #include <errno.h>			// error numbers and strings
 #include <signal.h> 		// for SIGs, handling in main, raise in update
+#include <poll.h>			// wait for data on the API socket
+#include <sys/socket.h>		// Engine API connection
+#include <sys/un.h>			// unix domain socket address
+#include <stdatomic.h>		// lock-free event queue
 
 #include "kernutil.h"	// used for custom pipes
 #include "error.h"		// error and stderr print functions
 #include "cmnutil.h"	// common definitions and functions
-#include "parse_func.h"
 
 
 #define INTERV_RFSH			1000
+#define DLINK_RETRY			1000000	// ns, wait for space in the event queue
 
 #undef PFX
 #define PFX "[dockerlink] "
@@ -19,6 +23,15 @@
 #define DEFAULT_MEM_BUF_SIZE (4 * 1024 * 1024)
 
 #define DOCKER_CMD_LINE "docker events --format '{{json .}}'"
+#define DOCKER_SOCK_PFX "unix://"				// prefix of socket arguments and DOCKER_HOST
+#define DOCKER_SOCK		"/var/run/docker.sock"	// default Engine API endpoint
+// container events only, filters={"type":["container"]}
+#define DOCKER_API_EVENTS "GET /events?filters=%7B%22type%22%3A%5B%22container%22%5D%7D HTTP/1.1\r\n" \
+						"Host: docker\r\n\r\n"
+#define DOCKER_API_UPDATE "POST /containers/%s/update HTTP/1.1\r\nHost: docker\r\n" \
+						"Content-Type: application/json\r\nContent-Length: %d\r\n" \
+						"Connection: close\r\n\r\n%s"
+#define DOCKER_API_TOUT	1	// s, timeout for requests other than events
 
 int th_return = EXIT_SUCCESS;
 
@@ -35,19 +48,81 @@ static void dlink_inthand (int sig, siginfo_t *siginfo, void *context){
 }
 
 FILE * inpipe;
-pthread_mutex_t containerMutex; // data access mutex
-contevent_t * containerEvent; // data
-	
+
+// bounded MPSC queue of container events, see dlink_push/dlink_pop
+// slot sequence is stored relative to the slot index so that the zero
+// initialized queue is empty: seq(i) = dlink_ring[i].seq + i
+static struct dlink_slot {
+	_Atomic size_t seq;		// == pos free for producer, == pos+1 ready for consumer
+	contevent_t evnt;
+} dlink_ring[DLINK_RINGSZ];
+static _Atomic size_t dlink_head;	// next position to reserve, producers
+static size_t dlink_tail;			// next position to read, consumer only
+_Atomic uint64_t dlink_overflow;	// refused pushes, queue full
+
+// Engine API connection, streaming HTTP/JSON reader
+static struct dlink_sock {
+	int fd;						// socket, -1 = reading from CLI pipe
+	int eof;					// end of stream or connection error
+	int chunked;				// body uses chunked transfer encoding
+	size_t chunk;				// bytes left in current chunk
+	size_t pos;					// read position in buf
+	size_t len;					// bytes in buf
+	char buf[JSON_FILE_BUF_SIZE];
+} dsock = { .fd = -1 };
+static const char * _Atomic dlink_api;	// socket path while connected, NULL = CLI
+
+#define DLINK_KEYLEN	16	// longest key of interest + 1, "Attributes"
+#define DLINK_TYPELEN	16	// type and status, longer values never match
+#define DLINK_IDLEN		72	// container id, 64 hex digits
+#define DLINK_NAMELEN	256	// container and image name
+#define DLINK_DEPTH		16	// max nesting of event objects
+
+// fields of an event we use, also bit numbers in eventData.seen
+enum eventField {
+	evfld_none,
+	evfld_type,			// Type
+	evfld_status,		// status
+	evfld_id,			// id
+	evfld_from,			// from
+	evfld_scope,		// scope, presence only
+	evfld_time,			// timeNano
+	evfld_actor,		// Actor
+	evfld_attrib,		// Actor.Attributes
+	evfld_name			// Actor.Attributes.name
+};
+
+// preallocated event record, reused for every event
 struct eventData {
-	char * type;
-	char * status;
-	char * name;
-	char * id;
-	char * from;
-	char * scope;
+	char type[DLINK_TYPELEN];
+	char status[DLINK_TYPELEN];
+	char name[DLINK_NAMELEN];
+	char id[DLINK_IDLEN];
+	char from[DLINK_NAMELEN];
 	uint64_t timenano;
+	int seen;			// fields found, bit per enum eventField
+	int trunc;			// fields truncated, bit per enum eventField
 };
 
+// streaming event tokener, extracts only the fields above and keeps its
+// state between calls, i.e. objects may be split over reads or chunks
+static struct dlink_tok {
+	int depth;					// nesting level, 0 = between objects
+	int ctx[DLINK_DEPTH+1];		// enum eventField that opened the level, -1 = array
+	int key;					// next string is a key
+	int instr;					// inside a string, 2 = key
+	int esc;					// last string character was '\'
+	int inval;					// inside a number or literal
+	int numok;					// number is a plain integer
+	int field;					// field of the current value
+	char * dst;					// string value destination, NULL = skip
+	size_t dlen;				// bytes written to dst
+	size_t dmax;				// size of dst
+	char kbuf[DLINK_KEYLEN];	// current key
+	size_t klen;
+	struct eventData evnt;		// record of the last complete object
+} dtok;
+
 // possible docker events, v 1.18
 enum dockerEvents {
     dkrevnt_attach,
@@ -76,15 +151,313 @@ enum dockerEvents {
     dkrevnt_update
 	};
 
+/// dlink_push(): enqueue a container event, safe for multiple producers
+///
+/// Arguments: - event to copy into the queue, string ownership moves
+///				 to the queue on success
+///
+/// Return value: 0 on success, -1 if the queue is full
+int dlink_push(const contevent_t * evnt){
+
+	size_t pos = atomic_load_explicit(&dlink_head, memory_order_relaxed);
+	struct dlink_slot * slot;
+
+	for (;;) {
+		slot = &dlink_ring[pos & (DLINK_RINGSZ-1)];
+		size_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire)
+				+ (pos & (DLINK_RINGSZ-1));
+		intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+		if (!diff) {
+			// slot free, reserve it
+			if (atomic_compare_exchange_weak_explicit(&dlink_head, &pos, pos+1,
+					memory_order_relaxed, memory_order_relaxed))
+				break;
+		}
+		else if (0 > diff) {
+			// consumer did not free the slot yet, full
+			(void)atomic_fetch_add_explicit(&dlink_overflow, 1, memory_order_relaxed);
+			return -1;
+		}
+		else
+			pos = atomic_load_explicit(&dlink_head, memory_order_relaxed);
+	}
+
+	slot->evnt = *evnt;
+	atomic_store_explicit(&slot->seq, pos + 1 - (pos & (DLINK_RINGSZ-1)),
+			memory_order_release);
+	return 0;
+}
+
+/// dlink_pop(): dequeue container events, single consumer only
+///
+/// Arguments: - array to fill with events, caller owns strings after return
+///			   - max number of events to read
+///
+/// Return value: number of events read, 0 if empty
+int dlink_pop(contevent_t * evnts, int max){
+
+	int cnt = 0;
+
+	for (; cnt < max; cnt++, dlink_tail++) {
+		struct dlink_slot * slot = &dlink_ring[dlink_tail & (DLINK_RINGSZ-1)];
+		size_t idx = dlink_tail & (DLINK_RINGSZ-1);
+
+		// still empty or producer writing
+		if (atomic_load_explicit(&slot->seq, memory_order_acquire) + idx
+				!= dlink_tail + 1)
+			break;
+
+		evnts[cnt] = slot->evnt;
+		// free slot for the producer of the next round
+		atomic_store_explicit(&slot->seq, dlink_tail + DLINK_RINGSZ - idx,
+				memory_order_release);
+	}
+
+	return cnt;
+}
+
+/// tok_key(): map a key to the field of interest in the current object
+///
+/// Arguments: - tokener with completed key
+///
+/// Return value: enum eventField, evfld_none if not of interest
+static int tok_key(struct dlink_tok * tok){
+
+	static const struct { int ctx; const char * key; int field; } keys[] = {
+		{ evfld_none,	"Type",		evfld_type },
+		{ evfld_none,	"status",	evfld_status },
+		{ evfld_none,	"id",		evfld_id },
+		{ evfld_none,	"from",		evfld_from },
+		{ evfld_none,	"scope",	evfld_scope },
+		{ evfld_none,	"timeNano",	evfld_time },
+		{ evfld_none,	"Actor",	evfld_actor },
+		{ evfld_actor,	"Attributes", evfld_attrib },
+		{ evfld_attrib,	"name",		evfld_name },
+	};
+
+	// truncated keys never match
+	if (DLINK_KEYLEN <= tok->klen)
+		return evfld_none;
+	tok->kbuf[tok->klen] = '\0';
+
+	// root object has ctx none, others nested only through Actor
+	int ctx = (1 == tok->depth) ? evfld_none : tok->ctx[tok->depth];
+	if (1 != tok->depth && evfld_none == ctx)
+		return evfld_none;
+
+	for (int i = 0; i < (int)(sizeof(keys)/sizeof(keys[0])); i++)
+		if (keys[i].ctx == ctx && !strcmp(keys[i].key, tok->kbuf))
+			return keys[i].field;
+	return evfld_none;
+}
+
+/// tok_value(): start a string value, set destination if of interest
+///
+/// Arguments: - tokener
+///
+/// Return value: -
+static void tok_value(struct dlink_tok * tok){
+	struct eventData * evnt = &tok->evnt;
+
+	tok->dlen = 0;
+	switch (tok->field) {
+		case evfld_type:
+			tok->dst = evnt->type; tok->dmax = sizeof(evnt->type); break;
+		case evfld_status:
+			tok->dst = evnt->status; tok->dmax = sizeof(evnt->status); break;
+		case evfld_id:
+			tok->dst = evnt->id; tok->dmax = sizeof(evnt->id); break;
+		case evfld_from:
+			tok->dst = evnt->from; tok->dmax = sizeof(evnt->from); break;
+		case evfld_name:
+			tok->dst = evnt->name; tok->dmax = sizeof(evnt->name); break;
+		case evfld_scope:
+			// presence only
+			evnt->seen |= 1 << evfld_scope;
+			// no break
+		default:
+			tok->dst = NULL;
+			break;
+	}
+}
+
+/// tok_feed(): run the event tokener over a piece of the stream
+///
+/// Arguments: - tokener with state of previous calls
+///			   - data to parse
+///			   - length of data
+///			   - bytes consumed, up to and including the end of an object
+///
+/// Return value: 1 if an object is complete, 0 if more data is needed,
+///				  -1 on syntax error
+static int tok_feed(struct dlink_tok * tok, const char * buf, size_t len, size_t * used){
+
+	struct eventData * evnt = &tok->evnt;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		char c = buf[i];
+
+		if (tok->instr) {
+			if (1 == tok->instr && !tok->dst && !tok->esc) {
+				// value not of interest, skip to its end
+				while (i < len && '"' != buf[i] && '\\' != buf[i])
+					i++;
+				if (i >= len)
+					break;
+				c = buf[i];
+			}
+
+			if (tok->esc)
+				tok->esc = 0;	// escaped char is copied as is
+			else if ('\\' == c) {
+				tok->esc = 1;
+				continue;
+			}
+			else if ('"' == c) {
+				if (2 == tok->instr)
+					tok->field = tok_key(tok);
+				else if (tok->dst) {
+					tok->dst[tok->dlen] = '\0';
+					evnt->seen |= 1 << tok->field;
+				}
+				tok->instr = 0;
+				continue;
+			}
+
+			if (2 == tok->instr) {
+				if (DLINK_KEYLEN > tok->klen)
+					tok->kbuf[tok->klen] = c;
+				tok->klen++;
+			}
+			else if (tok->dst) {
+				if (tok->dlen + 1 < tok->dmax)
+					tok->dst[tok->dlen++] = c;
+				else
+					evnt->trunc |= 1 << tok->field;
+			}
+			continue;
+		}
+
+		if (tok->inval) {
+			// numbers and literals end at the next structural char
+			if (isalnum((unsigned char)c) || '.' == c || '+' == c || '-' == c) {
+				if (!isdigit((unsigned char)c))
+					tok->numok = 0;
+				else if (evfld_time == tok->field)
+					evnt->timenano = evnt->timenano * 10 + (c - '0');
+				continue;
+			}
+			if (evfld_time == tok->field && tok->numok)
+				evnt->seen |= 1 << evfld_time;
+			tok->inval = 0;
+		}
+
+		if (isspace((unsigned char)c))
+			continue;
+
+		// outside objects only a new object may start
+		if (!tok->depth && '{' != c)
+			return -1;
+
+		switch (c) {
+			case '{':
+			case '[':
+				if (DLINK_DEPTH <= tok->depth)
+					return -1;
+				if (!tok->depth) {
+					// new event, reset record
+					evnt->seen = evnt->trunc = 0;
+					evnt->timenano = 0;
+					evnt->type[0] = evnt->status[0] = evnt->id[0] = '\0';
+					evnt->from[0] = evnt->name[0] = '\0';
+					tok->field = evfld_none;
+				}
+				tok->depth++;
+				tok->ctx[tok->depth] = ('[' == c) ? -1
+						: (evfld_actor == tok->field || evfld_attrib == tok->field)
+							? tok->field : evfld_none;
+				tok->key = ('{' == c);
+				tok->field = evfld_none;
+				break;
+
+			case '}':
+			case ']':
+				if (('}' == c) == (-1 == tok->ctx[tok->depth]))
+					return -1;
+				tok->depth--;
+				tok->key = 0;
+				tok->field = evfld_none;
+				if (!tok->depth) {
+					*used = i + 1;
+					return 1;
+				}
+				break;
+
+			case ':':
+				tok->key = 0;
+				break;
+
+			case ',':
+				tok->key = (-1 != tok->ctx[tok->depth]);
+				tok->field = evfld_none;
+				break;
+
+			case '"':
+				if (tok->key) {
+					tok->instr = 2;
+					tok->klen = 0;
+				}
+				else {
+					tok->instr = 1;
+					tok_value(tok);
+				}
+				break;
+
+			default:
+				if (!isalnum((unsigned char)c) && '-' != c)
+					return -1;
+				tok->inval = 1;
+				tok->numok = 0 != isdigit((unsigned char)c);
+				if (evfld_time == tok->field)
+					evnt->timenano = (tok->numok) ? (uint64_t)(c - '0') : 0;
+				break;
+		}
+	}
+
+	*used = i;
+	return 0;
+}
+
+/// tok_check(): verify that an event has all required fields
+///
+/// Arguments: - event record
+///
+/// Return value: 0 if complete, -1 otherwise
+static int tok_check(struct eventData * evnt){
+
+	int need = (1 << evfld_type) | (1 << evfld_scope) | (1 << evfld_time);
+	if ((evnt->seen & (1 << evfld_type)) && !strcmp(evnt->type, "container"))
+		need |= (1 << evfld_status) | (1 << evfld_id) | (1 << evfld_from);
+
+	if ((evnt->seen & need) != need) {
+		err_msg("Event JSON incomplete, missing fields 0x%x", need & ~evnt->seen);
+		return -1;
+	}
+	if (evnt->trunc & ((1 << evfld_id) | (1 << evfld_from) | (1 << evfld_name)))
+		warn("Event fields truncated for %.12s", evnt->id);
+	return 0;
+}
+
 /// read_pipe(): read from pipe and parse JSON
 ///
-/// Arguments: event structure to fill with data from JSON
+/// Arguments: - 
 ///
-/// Return value: (void)
-static int read_pipe(struct eventData * evnt){
+/// Return value: 1 if an event has been read, 0 otherwise
+static int read_pipe(){
 
 	char buf[JSON_FILE_BUF_SIZE];
-	struct json_object *root;
 
 	buf[0] = '\0';
 
@@ -101,102 +474,321 @@ static int read_pipe(struct eventData * evnt){
 			continue;
 		}
 
-		root = json_tokener_parse(buf);
+		// one event per line, long lines continue in next read
+		size_t len = strlen(buf), used;
+		int ret = tok_feed(&dtok, buf, len, &used);
 
-		// root read successfully?
-		if (NULL == root) {
+		if (0 > ret || (!ret && !dtok.depth && '\n' == buf[len-1])) {
 			err_msg("Empty JSON");
 			th_return = EXIT_INV_CONFIG;
 			pthread_exit(&th_return);
 		}
 
-		evnt->type = get_string_value_from(root, "Type", FALSE, NULL);
-		if (!strcmp(evnt->type, "container")) {
-			evnt->status = get_string_value_from(root, "status", FALSE, NULL);
-			evnt->id = get_string_value_from(root, "id", FALSE, NULL);
-			evnt->from = get_string_value_from(root, "from", FALSE, NULL);
-			struct json_object *actor, *attrib;
-
-			actor = get_in_object(root, "Actor", TRUE);
-			if (actor) {
-				// not status type, ID is here
-	//			if (!evnt->id)
-	//				evnt->id = get_string_value_from(actor, "ID", FALSE, NULL);
-				attrib = get_in_object(actor, "Attributes", TRUE);
-				if (attrib)
-					evnt->name = get_string_value_from(attrib, "name", FALSE, NULL);
+		if (ret) {
+			if (tok_check(&dtok.evnt)) {
+				th_return = EXIT_INV_CONFIG;
+				pthread_exit(&th_return);
 			}
+			return 1;
 		}
-		evnt->scope = get_string_value_from(root, "scope", FALSE, NULL);
-		evnt->timenano = get_int64_value_from(root, "timeNano", FALSE, 0);
-		if (!json_object_put(root)){ // free object
-			printDbg(PFX "Could not free objects!\n");
-			th_return = EXIT_FAILURE;
-			pthread_exit(&th_return);
-		}
-		return 1;
 	}
 
 	// reading stopped. no new element
 	return 0;
 }
 
-/// check_event(): call pipe read and parse response
+/// sock_fill(): read more data from the API socket into the buffer
+///
+/// Arguments: - 
+///
+/// Return value: bytes read, 0 at end of stream, -1 on error or stop
+static int sock_fill(){
+
+	// drop consumed data
+	if (dsock.pos) {
+		dsock.len -= dsock.pos;
+		(void)memmove(dsock.buf, dsock.buf + dsock.pos, dsock.len);
+		dsock.pos = 0;
+	}
+	if (dsock.len >= sizeof(dsock.buf)) {
+		warn("Engine API line exceeds buffer");
+		dsock.eof = 1;
+		return -1;
+	}
+
+	struct pollfd pfd = { .fd = dsock.fd, .events = POLLIN };
+	while (!dlink_stop) {
+		// wake up regularly to check for stop
+		int ret = poll(&pfd, 1, INTERV_RFSH);
+		if (0 == ret || (0 > ret && EINTR == errno))
+			continue;
+
+		ssize_t got = (0 < ret) ? read(dsock.fd, dsock.buf + dsock.len,
+				sizeof(dsock.buf) - dsock.len) : -1;
+		if (0 < got) {
+			dsock.len += got;
+			return (int)got;
+		}
+		if (0 > got && EINTR == errno)
+			continue;
+		if (0 > got)
+			warn("Engine API read failed: %s", strerror(errno));
+		dsock.eof = 1;
+		return (int)got;
+	}
+	return -1;
+}
+
+/// sock_line(): read a CRLF terminated line from the API socket
+///
+/// Arguments: - 
+///
+/// Return value: line without CRLF, valid until next read; NULL on EOF
+static char * sock_line(){
+
+	char * end;
+	while (!(end = memmem(dsock.buf + dsock.pos, dsock.len - dsock.pos, "\r\n", 2)))
+		if (0 >= sock_fill())
+			return NULL;
+
+	char * line = dsock.buf + dsock.pos;
+	*end = '\0';
+	dsock.pos = end + 2 - dsock.buf;
+	return line;
+}
+
+/// sock_close(): close the Engine API connection
+///
+/// Arguments: - 
+///
+/// Return value: -
+static void sock_close(){
+	if (0 <= dsock.fd)
+		(void)close(dsock.fd);
+	dsock.fd = -1;
+}
+
+/// sock_connect(): connect to the Engine API and send a request
+///
+/// Arguments: - path of the unix socket
+///			   - request to send
+///			   - connect, send and receive timeout in s, 0 = blocking
+///
+/// Return value: socket, -1 on error with errno set
+static int sock_connect(const char * path, const char * req, time_t tout){
+
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+	(void)strcpy(addr.sun_path, path);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (0 > fd)
+		return -1;
+
+	// unix sockets apply the send timeout to connect as well
+	struct timeval tv = { tout, 0 };
+	if (((tout) && (setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv))
+				|| setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv))))
+			|| connect(fd, (struct sockaddr *)&addr, sizeof(addr))
+			|| (ssize_t)strlen(req) != send(fd, req, strlen(req), MSG_NOSIGNAL)) {
+		int err = errno;
+		(void)close(fd);
+		errno = err;
+		return -1;
+	}
+	return fd;
+}
+
+/// sock_open(): connect to the Engine API and subscribe to container events
+///
+/// Arguments: - path of the unix socket
+///
+/// Return value: 0 on success, -1 on error with errno set
+static int sock_open(const char * path){
+
+	dsock.eof = dsock.chunked = 0;
+	dsock.chunk = dsock.pos = dsock.len = 0;
+	if (0 > (dsock.fd = sock_connect(path, DOCKER_API_EVENTS, 0)))
+		return -1;
+
+	// status line, HTTP/1.x 200
+	char * line = sock_line();
+	int code = 0;
+	if (!line || 1 != sscanf(line, "HTTP/%*s %d", &code) || 200 != code) {
+		warn("Engine API request refused, status %d", code);
+		errno = EPROTO;
+		goto fail;
+	}
+
+	// headers, events are streamed chunked
+	while ((line = sock_line()) && *line)
+		if (!strncasecmp(line, "Transfer-Encoding:", 18) && strcasestr(line + 18, "chunked"))
+			dsock.chunked = 1;
+	if (!line) {
+		errno = EPROTO;
+		goto fail;
+	}
+	return 0;
+
+fail:
+	{
+		int err = errno;
+		sock_close();
+		errno = err;
+	}
+	return -1;
+}
+
+/// read_sock(): read from Engine API stream and parse JSON
 ///
 /// Arguments: - 
 ///
-/// Return value: pointer to valid container event
-static contevent_t * check_event() {
-
-	struct eventData evnt;
-	memset(&evnt, 0, sizeof(struct eventData)); // set all pointers to NULL -> init
-
-	// read next element from pipe
-	if (!read_pipe(&evnt))
-		return NULL; // return if empty
-
-	// parse element
-	contevent_t * cntevent = NULL; // return element, default - null
-
-	if (evnt.type && !strcmp(evnt.type, "container")){
-		// kill	
-		if ((!strcmp(evnt.status, "kill")))
-		{
-			cntevent = malloc(sizeof(contevent_t));
-			
-			cntevent->event = cnt_remove;
-			cntevent->name = strdup(evnt.name);
-			cntevent->id = strdup(evnt.id);
-			cntevent->image = strdup(evnt.from);
-			cntevent->timenano = evnt.timenano;
+/// Return value: 1 if an event has been read, 0 otherwise
+static int read_sock(){
+
+	while (!(dlink_stop) && !dsock.eof){
+
+		// next chunk size, data of the previous chunk ends with CRLF
+		if (dsock.chunked && !dsock.chunk) {
+			char * line = sock_line();
+			if (line && !*line)
+				line = sock_line();
+			if (!line)
+				break;
+			if (!(dsock.chunk = strtoul(line, NULL, 16))) {
+				dsock.eof = 1; // last-chunk, stream closed
+				break;
+			}
 		}
-		else if (!strcmp(evnt.status, "start"))
-		{
-			cntevent = malloc(sizeof(contevent_t));
-			
-			cntevent->event = cnt_add;
-			cntevent->name = strdup(evnt.name);
-			cntevent->id = strdup(evnt.id);
-			cntevent->image = strdup(evnt.from);
-			cntevent->timenano = evnt.timenano;
+
+		if (dsock.pos >= dsock.len && 0 >= sock_fill())
+			break;
+
+		size_t cnt = dsock.len - dsock.pos;
+		if (dsock.chunked && cnt > dsock.chunk)
+			cnt = dsock.chunk;
+
+		// parse what we have, the tokener keeps partial objects
+		size_t used;
+		int ret = tok_feed(&dtok, dsock.buf + dsock.pos, cnt, &used);
+		if (0 > ret || (ret && tok_check(&dtok.evnt))) {
+			if (0 > ret)
+				err_msg("Invalid JSON in event stream");
+			sock_close();
+			th_return = EXIT_INV_CONFIG;
+			pthread_exit(&th_return);
 		}
+
+		dsock.pos += used;
+		if (dsock.chunked)
+			dsock.chunk -= used;
+
+		if (ret)
+			return 1;
+	}
+
+	// reading stopped. no new element
+	return 0;
+}
+
+/// dlink_cpuset(): set the CPU-set of a container through the Engine API,
+/// works also for created containers that did not start yet
+///
+/// Arguments: - container id
+///			   - CPU list string, e.g. "2-3"
+///
+/// Return value: 0 on success, -1 on error with errno set,
+///				  ENOTCONN if events are read through the CLI
+int dlink_cpuset(const char * id, const char * cpus){
+
+	const char * path = dlink_api;
+	if (!path) {
+		errno = ENOTCONN;
+		return -1;
+	}
+
+	char body[CPUSTRLEN + 20];
+	char req[JSON_FILE_BUF_SIZE];
+	int len = snprintf(body, sizeof(body), "{\"CpusetCpus\":\"%s\"}", cpus);
+	if ((int)sizeof(body) <= len
+			|| (int)sizeof(req) <= snprintf(req, sizeof(req), DOCKER_API_UPDATE, id, len, body)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	int fd = sock_connect(path, req, DOCKER_API_TOUT);
+	if (0 > fd)
+		return -1;
+
+	// status line is all we need
+	char buf[64];
+	int code = 0;
+	ssize_t got = -1;
+	if (0 >= (got = recv(fd, buf, sizeof(buf)-1, 0))) {
+		int err = (got) ? errno : EPROTO;	// 0 = closed without reply
+		(void)close(fd);
+		errno = err;
+		return -1;
+	}
+	(void)close(fd);
+	buf[got] = '\0';
+
+	if (1 != sscanf(buf, "HTTP/%*s %d", &code) || 200 != code) {
+		printDbg(PFX "Update of %.12s refused, status %d\n", id, code);
+		errno = EPROTO;
+		return -1;
 	}
+	return 0;
+}
 
-	// free elements
-	free(evnt.type);
-	free(evnt.status);
-	free(evnt.name);
-	free(evnt.id);
-	free(evnt.from);
-	free(evnt.scope);
-	// free main
+/// make_event(): map a parsed event to a container event
+///
+/// Arguments: - parsed event record
+///			   - container event to fill, strings are allocated
+///
+/// Return value: 1 if the event is of interest, 0 otherwise
+static int make_event(struct eventData * evnt, contevent_t * cntevent) {
+
+	if (strcmp(evnt->type, "container"))
+		return 0;
+
+	if (!strcmp(evnt->status, "kill"))
+		cntevent->event = cnt_remove;
+	else if (!strcmp(evnt->status, "create"))
+		cntevent->event = cnt_create;
+	else if (!strcmp(evnt->status, "start"))
+		cntevent->event = cnt_add;
+	else
+		return 0;
 
-	return cntevent;
+	cntevent->name = strdup(evnt->name);
+	cntevent->id = strdup(evnt->id);
+	cntevent->image = strdup(evnt->from);
+	cntevent->timenano = evnt->timenano;
+	return 1;
+}
+
+/// check_event(): call pipe read and parse response
+///
+/// Arguments: - container event to fill
+///
+/// Return value: 1 if a container event has been read, 0 otherwise
+static int check_event(contevent_t * cntevent) {
+
+	// read next element from socket or pipe
+	if (!((0 <= dsock.fd) ? read_sock() : read_pipe()))
+		return 0; // return if empty
+
+	return make_event(&dtok.evnt, cntevent);
 }
 
 /// dlink_thread_watch(): checks for docker events and signals new containers
 ///
-/// Arguments: - 
+/// Arguments: - command line to read events from, or 'unix://' socket path,
+///				 NULL = Engine API at DOCKER_HOST or default socket, CLI fallback
 ///
 /// Return value: pointer to void (PID exits with error if needed)
 void *dlink_thread_watch(void *arg) {
@@ -204,7 +796,7 @@ void *dlink_thread_watch(void *arg) {
 	int pstate = 0;
 	pid_t pid;
 	char * pcmd;
-	contevent_t * cntevent;
+	contevent_t cntevent;
 
 	{ // setup interrupt handler block
 		struct sigaction act;
@@ -238,10 +830,17 @@ void *dlink_thread_watch(void *arg) {
 		}
 	}
 	
+	char * psock = NULL;
 	if (NULL != arg)
 		pcmd = (char *)arg;
-	else
+	else {
 		pcmd = DOCKER_CMD_LINE;
+		psock = getenv("DOCKER_HOST");
+		if (!psock || strncmp(psock, DOCKER_SOCK_PFX, strlen(DOCKER_SOCK_PFX)))
+			psock = DOCKER_SOCK_PFX DOCKER_SOCK;
+	}
+	if (!strncmp(pcmd, DOCKER_SOCK_PFX, strlen(DOCKER_SOCK_PFX)))
+		psock = pcmd;
 
 	int ret;
 	struct timespec intervaltv;
@@ -258,6 +857,22 @@ void *dlink_thread_watch(void *arg) {
 		switch (pstate) {
 
 			case 0: 
+				memset(&dtok, 0, sizeof(dtok)); // fresh tokener per stream
+				if (psock) {
+					if (!sock_open(psock + strlen(DOCKER_SOCK_PFX))) {
+						dlink_api = psock + strlen(DOCKER_SOCK_PFX);
+						pstate = 1;
+						printDbg(PFX "Reading JSON stream from Engine API...\n");
+						break;
+					}
+					// explicit socket requested, no fallback
+					if (psock == pcmd) {
+						err_msg_n(errno, "Engine API connection failed!");
+						th_return = EXIT_FAILURE;
+						pthread_exit(&th_return);
+					}
+					info("Docker Engine API not available, using CLI: %s", strerror(errno));
+				}
 				if (!(inpipe = popen2 (pcmd, "r", &pid))){
 					err_msg_n(errno, "Pipe process open failed!");
 					th_return = EXIT_FAILURE;
@@ -268,38 +883,40 @@ void *dlink_thread_watch(void *arg) {
 				// no break
 
 			case 1:
-				if (feof(inpipe))
+				if ((0 <= dsock.fd) ? dsock.eof : feof(inpipe))
 					pstate = 4;
-				else if ((cntevent = check_event()))  // new event?
+				else if (check_event(&cntevent))  // new event?
 					pstate = 2;
 				break;
 
 			case 2:
-				// put new event to 
-				(void)pthread_mutex_lock(&containerMutex);
-				
-				if (!containerEvent)
-					pstate = 3;
-				else
-					(void)pthread_mutex_unlock(&containerMutex);
-				break;
-
-			case 3:
-				containerEvent = cntevent;
-				(void)pthread_mutex_unlock(&containerMutex);
-				cntevent = NULL;
+				// put new event to queue, retry until the consumer made space
+				if (dlink_push(&cntevent)) {
+					(void)clock_nanosleep(CLOCK_MONOTONIC, 0,
+						&(struct timespec){ 0, DLINK_RETRY }, NULL);
+					break;
+				}
 				pstate = 1;
 				break;
 
+			case 5: // stopped while queue full
+				free(cntevent.name);
+				free(cntevent.id);
+				free(cntevent.image);
+				// no break
+
 			case 4:
-				if (inpipe)
+				dlink_api = NULL;
+				if (0 <= dsock.fd)
+					sock_close();
+				else if (inpipe)
 					pclose2(inpipe, pid, SIGHUP);
 				printDbg(PFX "Stopped\n");
 				pthread_exit(&th_return);
 		}
 
-		if (3 > pstate && dlink_stop){ // if 3 wait for change, lock is hold
-			pstate=4;
+		if (4 > pstate && dlink_stop){
+			pstate = (2 == pstate) ? 5 : 4;
 		}
 	}
 }
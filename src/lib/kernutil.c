@@ -811,6 +811,28 @@ string_to_affinity(const char *str)
 	return 0; // default to other
 }
 
+/*
+ *  string_to_admission(): match string with an admission test
+ *
+ *  Arguments: - string identifying admission test
+ *
+ *  Return value: returns admission enumeration constant, 0 (utilization) if failed
+ */
+uint32_t
+string_to_admission(const char *str)
+{
+	if (!strcmp(str, "utilization"))
+		return ADM_ULIMIT;
+	else if (!strcmp(str, "demand"))
+		return ADM_DEMAND;
+	else if (!strcmp(str, "rta"))
+		return ADM_RTA;
+	else if (!strcmp(str, "exact"))
+		return ADM_EXACT;
+	warn("Unrecognized value '%s' for admission setting", str);
+	return ADM_ULIMIT; // default to utilization
+}
+
 /*
  *  get_status_flags(): compose a status string from process status flag
  *
@@ -363,6 +363,10 @@ freePrgSet(prgset_t * prgset){
 
 	free(prgset->cpusetdfileprefix);
 
+	// trace record and replay
+	free(prgset->trace_rec);
+	free(prgset->trace_play);
+
 	free(prgset);
 }
 
@@ -376,6 +380,10 @@ freePrgSet(prgset_t * prgset){
 void
 freeTracer(resTracer_t ** rHead){
 	while (*rHead){
+		// tasks are no longer accounted
+		for (node_t * node = (*rHead)->tasks; ((node)); node = node->mon.tnext)
+			node->mon.trc = NULL;
+
 		numa_free_cpumask((*rHead)->affinity);
 		pop((void**)rHead);
 	}
@@ -399,18 +407,45 @@ static const node_t _node_default = { NULL,				// *next,
 							NULL, NULL,					// 		*pointer to fitting data for runtime
 							NULL, NULL,					// 		*pointer to fitting data for period (NON_RT)
 							-1, NULL,					//		assignment CPU, *assignment mask runtime
-							0, 0						//		reschedule-, resample count
+							0, 0,						//		reschedule-, resample count
+							NULL, NULL					//		*tracer, *next task of tracer
 						},
 						NULL};							// *param structure pointer
 
 /* -------------------- RUNTIME structure ----------------------*/
 
+///	nodes come from slabs of NODE_SLABSZ and return to a free list on pop,
+/// memory is reused for the lifetime of the program. Update thread only
+
+#define NODE_SLABSZ	64			// nodes per slab
+
+struct node_slab {
+	struct node_slab * next;
+	node_t nodes[NODE_SLABSZ];
+};
+
+static struct node_slab * node_slabs;	// allocated slabs
+static node_t * node_free;				// free nodes, linked by next
+
 void node_push(node_t ** head) {
-	push((void**)head, sizeof(node_t));
+	if (!node_free){
+		struct node_slab * slab = malloc(sizeof(struct node_slab));
+		if (!slab)
+			err_exit("could not allocate memory!");
+		slab->next = node_slabs;
+		node_slabs = slab;
+		for (int i = NODE_SLABSZ-1; i >= 0; i--){
+			slab->nodes[i].next = node_free;
+			node_free = &slab->nodes[i];
+		}
+	}
+
 	// set default and get back
-	void* next = (*head)->next;
-	**head = _node_default;
-    (*head)->next = next;
+	node_t * node = node_free;
+	node_free = node->next;
+	*node = _node_default;
+	node->next = *head;
+	*head = node;
 }
 
 void node_pop(node_t ** head) {
@@ -471,7 +506,228 @@ void node_pop(node_t ** head) {
 	(*head)->mon.assigned_mask = NULL;
 #endif
 
-	pop((void**)head);
+	node_idxDel(*head);
+	node_trcDel(*head);
+
+	// back to the free list
+	node_t * node = *head;
+	*head = node->next;
+	node->next = node_free;
+	node_free = node;
+}
+
+/// node_slabFree(): free the memory of all nodes, none may be in use
+///
+/// Arguments: -
+///
+/// Return value: -
+///
+void
+node_slabFree(){
+	while (node_slabs){
+		struct node_slab * slab = node_slabs;
+		node_slabs = slab->next;
+		free(slab);
+	}
+	node_free = NULL;
+}
+
+/* -------------------- resource tracer task lists ----------------------*/
+
+/// node_trcAdd(): append a node to the task list of a resource tracer,
+///				   the caller accounts its times
+///
+/// Arguments: - resource tracer
+///			   - node to add, must not be in a task list
+///
+/// Return value: -
+///
+void
+node_trcAdd(resTracer_t * trc, node_t * node){
+	node->mon.trc = trc;
+	node->mon.tnext = NULL;
+	*((trc->ttail) ? trc->ttail : &trc->tasks) = node;
+	trc->ttail = &node->mon.tnext;
+}
+
+/// node_trcDel(): remove a node from the task list of its resource tracer,
+///				   marks the tracer times as outdated
+///
+/// Arguments: - node to remove
+///
+/// Return value: -
+///
+void
+node_trcDel(node_t * node){
+	resTracer_t * trc = node->mon.trc;
+	if (!trc)
+		return;
+
+	for (node_t ** link = &trc->tasks; *link; link = &(*link)->mon.tnext)
+		if (*link == node){
+			*link = node->mon.tnext;
+			if (trc->ttail == &node->mon.tnext)
+				trc->ttail = link;
+			break;
+		}
+
+	trc->status |= MSK_STATTUPD;
+	node->mon.trc = NULL;
+	node->mon.tnext = NULL;
+}
+
+/* -------------------- PID lookup index ----------------------*/
+
+///	open addressing hash table with linear probing, indexes nodes of nhead
+/// by PID. Entries are located by absolute PID value so that deactivated
+/// (negated) nodes can still be removed. Size is always a power of 2
+
+#define NODE_IDXMIN	64			// minimum index size
+
+static node_t ** node_idx;		// index table
+static size_t node_idxsz;		// table size, power of 2
+static size_t node_idxcnt;		// used entries
+static uint32_t node_idxgen;	// generation, changes with the indexed PID set
+
+static inline size_t
+node_idxHash(pid_t pid){
+	// multiplicative (Knuth) hashing, drop low bits that vary little
+	return (size_t)(((uint32_t)abs(pid) * 2654435761U) >> 7) & (node_idxsz-1);
+}
+
+static void
+node_idxInsert(node_t * node){
+	size_t i = node_idxHash(node->pid);
+
+	while (node_idx[i]){
+		if (node_idx[i]->pid == node->pid){
+			// same PID, replace entry
+			node_idx[i] = node;
+			return;
+		}
+		i = (i + 1) & (node_idxsz-1);
+	}
+	node_idx[i] = node;
+	node_idxcnt++;
+}
+
+static void
+node_idxGrow(){
+	node_t ** old = node_idx;
+	size_t oldsz = node_idxsz;
+
+	node_idxsz = (oldsz) ? oldsz * 2 : NODE_IDXMIN;
+	if (!(node_idx = calloc(node_idxsz, sizeof(node_t *))))
+		err_exit("could not allocate memory!");
+	node_idxcnt = 0;
+
+	for (size_t i=0; i<oldsz; i++)
+		if (old[i])
+			node_idxInsert(old[i]);
+	free(old);
+}
+
+/// node_idxAdd(): add node to the PID lookup index
+///
+/// Arguments: - node to add, PID must be set and positive
+///
+/// Return value: -
+///
+void
+node_idxAdd(node_t * node){
+	if (!node || 0 >= node->pid)
+		return;
+
+	// keep load factor below 1/2
+	if ((node_idxcnt + 1) * 2 > node_idxsz)
+		node_idxGrow();
+
+	node_idxInsert(node);
+	node_idxgen++;
+}
+
+/// node_idxDel(): remove node from the PID lookup index, if present
+///
+/// Arguments: - node to remove
+///
+/// Return value: -
+///
+void
+node_idxDel(node_t * node){
+	if (!node || !node_idx || !node->pid)
+		return;
+
+	size_t i = node_idxHash(node->pid);
+	while (node_idx[i] && node_idx[i] != node)
+		i = (i + 1) & (node_idxsz-1);
+
+	if (!node_idx[i])
+		return; // not indexed
+
+	// backward shift deletion, keep probe sequences intact
+	size_t j = i;
+	node_idx[i] = NULL;
+	node_idxcnt--;
+	node_idxgen++;
+	for (;;) {
+		j = (j + 1) & (node_idxsz-1);
+		if (!node_idx[j])
+			break;
+
+		size_t k = node_idxHash(node_idx[j]->pid);
+		// move entry if its home slot is not cyclically within (i, j]
+		if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j)))
+			continue;
+
+		node_idx[i] = node_idx[j];
+		node_idx[j] = NULL;
+		i = j;
+	}
+}
+
+/// node_idxGet(): find node with the given PID
+///
+/// Arguments: - PID to look for
+///
+/// Return value: pointer to the node, NULL if not found
+///
+node_t *
+node_idxGet(pid_t pid){
+	if (!node_idx || 0 >= pid)
+		return NULL;
+
+	size_t i = node_idxHash(pid);
+	while (node_idx[i]){
+		if (node_idx[i]->pid == pid)
+			return node_idx[i];
+		i = (i + 1) & (node_idxsz-1);
+	}
+	return NULL;
+}
+
+/// node_idxGen(): get generation count of the indexed PID set
+///
+/// Arguments: -
+///
+/// Return value: counter, changes whenever a PID is added or removed
+///
+uint32_t
+node_idxGen(){
+	return node_idxgen;
+}
+
+/// node_idxFree(): free the PID lookup index
+///
+/// Arguments: -
+///
+/// Return value: -
+///
+void
+node_idxFree(){
+	free(node_idx);
+	node_idx = NULL;
+	node_idxsz = 0;
+	node_idxcnt = 0;
 }
 
 /* -------------------- END RUNTIME structure ----------------------*/
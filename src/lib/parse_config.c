@@ -541,6 +541,7 @@ static void parse_global(struct json_object *global, prgset_t *set)
 	set->runtime = get_int_value_from(global, "runtime", TRUE, set->runtime);
 	set->psigscan = get_bool_value_from(global, "psigscan", TRUE, set->psigscan);
 	set->trackpids = get_bool_value_from(global, "trackpids", TRUE, set->trackpids);
+	set->procevents = get_bool_value_from(global, "proc_events", TRUE, set->procevents);
 	// dryrun, cli only
 	set->lock_pages = get_bool_value_from(global, "lock_pages", TRUE, set->lock_pages);
 	// force, cli only
@@ -570,8 +571,20 @@ static void parse_global(struct json_object *global, prgset_t *set)
 	}
 	set->numa = get_string_value_from(global, "numa", TRUE, NULL);
 	set->ftrace = get_bool_value_from(global, "ftrace", TRUE, set->ftrace);
+	set->ftrace_rdrs = get_int_value_from(global, "ftrace_readers", TRUE, set->ftrace_rdrs);
 	set->ptresh = get_double_value_from(global, "ptresh", TRUE, set->ptresh);
 
+	if (!set->admission){
+	  // admission test selection switch block
+		char *admission;
+
+		admission = get_string_value_from(global, "admission",
+					       TRUE, "utilization");
+
+		set->admission = string_to_admission(admission);
+		free(admission);
+
+	} // END admission test selection switch block
 }
 
 /// config_set_default(): set default program parameters
@@ -609,6 +622,7 @@ void parse_config_set_default(prgset_t *set) {
 	set->runtime = 0;
 	set->psigscan = 0;
 	set->trackpids = 0;
+	set->procevents = 0;
 
 	set->dryrun = 0;
 	set->blindrun = 0;
@@ -626,10 +640,14 @@ void parse_config_set_default(prgset_t *set) {
 	set->numa = NULL;
 
 	set->ftrace = 0;
+	set->ftrace_rdrs = 0;
+	set->trace_rec = NULL;
+	set->trace_play = NULL;
 
 	set->use_cgroup = DM_CGRP;
 	set->sched_mode = SM_STATIC;
 	set->ptresh = 0.9;
+	set->admission = ADM_ULIMIT;
 }
 
 /// parse_config(): parse the JSON configuration and push back results
@@ -946,6 +946,34 @@ runstats_cdfSample(const stat_cdf * c, double r){
 	return gsl_histogram_pdf_sample(c, r);
 }
 
+/*
+ * runstats_cdfCopy() : copy a CDF, e.g., to sample it without holding a lock
+ *
+ * Arguments: - source CDF pointer
+ * 			  - CDF destination pointer, re-allocated if needed
+ *
+ * Return value: success or error code
+ */
+int
+runstats_cdfCopy(const stat_cdf * c, stat_cdf ** d){
+
+	if (!c || !d)
+		return GSL_EINVAL;
+
+	// re-alloc if number of bins differs
+	if (*d && ((*d)->n != c->n))
+		runstats_cdfFree(d);
+
+	if (!*d && !(*d = gsl_histogram_pdf_alloc(c->n)))
+		return GSL_ENOMEM;
+
+	// n+1 range limits and cumulative sums
+	(void)memcpy((*d)->range, c->range, (c->n + 1) * sizeof(double));
+	(void)memcpy((*d)->sum, c->sum, (c->n + 1) * sizeof(double));
+
+	return GSL_SUCCESS;
+}
+
 /*
  * runstats_cdffree() : CDF free
  *
@@ -138,6 +138,30 @@ recomputeTimes_S(struct resTracer * res) {
 	return rv;
 }
 
+/*
+ *  getAllocTasks(): fill admission test parameters of the allocations
+ *  				 planned on a resource
+ *
+ *  Arguments: - resource entry for this CPU
+ *  		   - task parameter array to fill, NULL = count only
+ *  		   - allocation to skip, NULL for none
+ *
+ *  Return value: number of tasks filled, or an upper bound if counting
+ */
+static int
+getAllocTasks(struct resTracer * res, admTask_t * tsk, void * skip) {
+	int n = 0;
+
+	for (resAlloc_t * alloc = aHead; ((alloc)); alloc=alloc->next){
+		if ((alloc->assigned != res) || (alloc == (resAlloc_t *)skip))
+			continue;
+
+		if ((!tsk) || !getAdmTask(alloc->item->attr, 0, &tsk[n]))
+			n++;
+	}
+	return n;
+}
+
 /*
  *  addTracer(): append resource with mask
  *
@@ -373,7 +397,8 @@ adaptPlanSchedule(){
 					unmatched++;
 				else {
 					// allocate resources for flexible tasks
-					trc= checkPeriod(res->item->attr, res->item->rscs->affinity, -1);
+					trc= checkPeriod_A(res->item->attr, res->item->rscs->affinity,
+							getAllocTasks, NULL);
 					if (trc){
 						(void)checkUvalue(trc, res->item->attr, 1);
 						res->assigned = trc;
@@ -394,7 +419,8 @@ adaptPlanSchedule(){
 					unmatched++;
 				else {
 					// allocate resources for flexible tasks
-					trc= checkPeriod(res->item->attr, res->item->rscs->affinity, -1);
+					trc= checkPeriod_A(res->item->attr, res->item->rscs->affinity,
+							getAllocTasks, NULL);
 					if (trc){
 						(void)checkUvalue(trc, res->item->attr, 1);
 						res->assigned = trc;
@@ -471,7 +497,8 @@ adaptScramble(){
 		if (!(res->assigned) ||(res->item->status & MSK_STATCFIX))
 				continue;
 
-		trc = checkPeriod(res->item->attr, res->item->rscs->affinity, -1);
+		trc = checkPeriod_A(res->item->attr, res->item->rscs->affinity,
+				getAllocTasks, res);
 		// found a better option?
 		if (trc && (trc != res->assigned)){
 			// recompute and add
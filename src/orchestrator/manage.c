@@ -13,6 +13,16 @@
 #include <fcntl.h>			// file control, new open/close functions
 #include <dirent.h>			// directory entry structure and exploration
 #include <errno.h>			// error numbers and strings
+#include <sys/epoll.h>		// I/O event notification, fTrace reader pool
+#include <sys/mman.h>		// memory mapping of ring-buffer pages
+#include <sys/ioctl.h>		// ring-buffer reader page control
+#include <poll.h>			// wait for ring-buffer data
+#include <stdarg.h>			// variable argument lists, record file names
+#include <sys/stat.h>		// directory creation, trace record
+#include <stddef.h>			// offsetof, event layout views
+#if __has_include(<linux/trace_mmap.h>)
+	#include <linux/trace_mmap.h> // ring-buffer memory map interface, kernel >= 6.10
+#endif
 #ifdef USELIBTRACE
 	#include <>kbuffer.h>	// ring-buffer management, use libtrace-event
 #endif
@@ -40,11 +50,32 @@
 
 #define ALPHAAVG_SECONDS	300	// how many seconds we want to "go back"
 
+#define MCBIN_SAMPLES		1000	// Monte-Carlo samples per reallocation decision
+#define MCBIN_BUDGET		10		// max share of the scan interval per manageSched() call, in %
+#define MCBIN_CHKSTEP		16		// samples between time budget checks
+#define MCBIN_ULMAX			1.0		// CPU utilization limit, above = overload
+
 // total scan counter for update-stats
 static uint64_t scount = 0; // total scan count
 // alpha for averaging
 static float alphaAVG = 0.99998;
 
+// Monte-Carlo bin-packing state, carried over manageSched() calls
+static struct mcbin_state {
+	uint32_t sig;		// signature of the task set and allocation sampled
+	int samples;		// samples drawn so far
+	int ncpu;			// number of resource tracers
+	int ngrp;			// number of container groups
+	int ntsk;			// number of tasks in the snapshot
+	int tsksz;			// allocated task and group entries
+	uint32_t * over;	// overload count per CPU
+	uint32_t * cover;	// overload count per group and target CPU
+	struct mcbin_task * tsk;	// task snapshot, sampled without lock
+	struct mcbin_grp * grp;		// container group snapshot
+	resTracer_t ** trcs;		// tracers of the snapshot, by index
+	uint64_t rnd;		// random generator state
+} mcb = { .rnd = 0x9E3779B97F4A7C15ULL };
+
 // #################################### THREAD configuration specific ############################################
 
 // linked list of event configuration fields
@@ -57,18 +88,103 @@ struct ftrace_ecfg {
 	int sign;
 };
 
+// event elaboration function
+typedef int (*ftrace_call_t)(const void *, const struct ftrace_thread *, uint64_t);
+
 // Linked list of event configurations and handlers
 struct ftrace_elist {
 	struct ftrace_elist * next;
 	char* event;	// string identifier
 	int eventid;	// event kernel ID
-	int (*eventcall)(const void *, const struct ftrace_thread *, uint64_t); // event elaboration function
+	ftrace_call_t eventcall; // event elaboration function
 	struct ftrace_ecfg* fields;
+	const char * const * fltfields; // PID fields for the kernel filter, NULL = unfiltered
 };
 struct ftrace_elist * elist_head;
 
+// Kernel-side event filter, PID set of the last update
+#define TR_FILTER_MAX		(PIPE_BUFFER-1)	// max filter string, kernel limit < PAGE_SIZE
+struct tr_pidrange {
+	pid_t lo;
+	pid_t hi;
+};
+static int64_t elist_fltgen = -1;	// node index generation of active filters, -1 = none
+
+// Adaptive ring-buffer sizing, per traced CPU
+#define TR_BUFPERIOD		USEC_PER_SEC	// evaluation period in us
+#define TR_BUFMAX_KB		65536			// upper bound for buffer_size_kb
+#define TR_BUFLOWFILL		8				// quiet if less than 1/n of buffer read per period
+#define TR_BUFQUIET			10				// quiet periods before shrinking
+
+// Trace record directory content, see --trace-record/--trace-replay
+#define TR_REC_EVENTS		"events"		// event IDs and names, one per line
+#define TR_REC_FORMAT		"%d.format"		// kernel format description of event ID
+#define TR_REC_CPUS			"cpus"			// traced CPU numbers, one per line
+#define TR_REC_PAGES		"cpu%d.raw"		// raw ring-buffer pages of a CPU
+
+// Replay of a recorded trace, readers and manage thread advance in trace time
+static pthread_mutex_t replay_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t replay_cond = PTHREAD_COND_INITIALIZER;
+static uint64_t replay_limit = 0;	// trace time readers may advance to, 0 = not started
+#define REPLAY_DONE			UINT64_MAX	// reader reached end of recording
+static _Atomic uint64_t record_time = 0;	// latest event time applied, recording only
+#define REPLAY_POLL			100000000	// max wait time in ns before checking for stop
+
+// Dispatch table of event handlers, indexed by 16 bit event ID, NULL = skip
+static ftrace_call_t * elist_disp = NULL;
+static int elist_dispsz = 0;
+
+// Decoded event of a ring-buffer page, applied in batch
+struct ftrace_bevent {
+	ftrace_call_t eventcall;
+	const void * addr;
+	uint64_t ts;
+};
+#define EVENT_BATCH			(PIPE_BUFFER/16)	// max events per lock, ~min event size
+
+#ifndef TRACE_MMAP_IOCTL_GET_READER
+// uapi of the ring-buffer memory map, kernel >= 6.10, for older headers
+struct trace_buffer_meta {
+	uint32_t	meta_page_size;
+	uint32_t	meta_struct_len;
+	uint32_t	subbuf_size;
+	uint32_t	nr_subbufs;
+	struct {
+		uint64_t	lost_events;
+		uint32_t	id;
+		uint32_t	read;
+	} reader;
+	uint64_t	flags;
+	uint64_t	entries;
+	uint64_t	overrun;
+	uint64_t	read;
+	uint64_t	Reserved1;
+	uint64_t	Reserved2;
+};
+#define TRACE_MMAP_IOCTL_GET_READER		_IO('R', 0x20)
+#endif
+
+// Memory mapped ring-buffer of a CPU, zero-copy page access
+struct ftrace_map {
+	int fd;								// raw trace pipe, -1 = not mapped
+	struct trace_buffer_meta * meta;	// meta page, reader page info
+	unsigned char * data;				// sub-buffers (pages)
+	size_t datasz;
+};
+
 struct ftrace_thread * elist_thead = NULL;
 
+// Linked list of pooled fTrace readers, each multiplexing several CPUs
+struct ftrace_reader {
+	struct ftrace_reader * next;
+	pthread_t thread;	// thread information
+	int iret;			// return value of thread launch
+	int cpuno;			// system CPU the reader is pinned to, -1 = none
+	int cnt;			// number of CPUs monitored
+	struct ftrace_thread ** fthreads; // CPUs monitored by this reader
+};
+struct ftrace_reader * elist_rhead = NULL;
+
 // variable types
 enum tr_vtypes { trv_short, trv_int, trv_long, trv_longlong, trv_char = 10, trv_pid_t = 20 };
 
@@ -111,6 +227,8 @@ const char * const tr_switch_dict[] = { TR_EVENT_SWITCH,
 										GET_VARIABLE_NAME(tr_switch.next_pid),
 										GET_VARIABLE_NAME(tr_switch.next_prio),
 										NULL};
+// PID fields to filter on, in kernel
+const char * const tr_switch_flt[] = { "prev_pid", "next_pid", NULL };
 
 // Parser offset structures - pointers to values for sched_wakeup
 #define TR_EVENT_WAKEUP "sched/sched_wakeup"
@@ -127,6 +245,113 @@ const char * const tr_wakeup_dict[] = { TR_EVENT_WAKEUP,
 										GET_VARIABLE_NAME(tr_wakeup.prio),
 										GET_VARIABLE_NAME(tr_wakeup.target_cpu),
 										NULL};
+// PID fields to filter on, in kernel
+const char * const tr_wakeup_flt[] = { "pid", NULL };
+
+// Packed views of known kernel event layouts, used when the parsed format
+// matches; otherwise the parsed offsets above are applied per field
+enum tr_layout { trl_offset, trl_std, trl_rt };	// parsed offsets, mainline, PREEMPT_RT
+
+#define TR_VIEW_COMMON \
+	uint16_t common_type; \
+	uint8_t  common_flags; \
+	uint8_t  common_preempt_count; \
+	int32_t  common_pid;
+
+struct tr_common_view {
+	TR_VIEW_COMMON
+} __attribute__((packed));
+
+struct tr_switch_view {		// mainline 4.x-6.x
+	TR_VIEW_COMMON
+	char	 prev_comm[16];
+	pid_t	 prev_pid;
+	int32_t	 prev_prio;
+	uint64_t prev_state;
+	char	 next_comm[16];
+	pid_t	 next_pid;
+	int32_t	 next_prio;
+} __attribute__((packed));
+
+struct tr_switch_view_rt {	// PREEMPT_RT, lazy preempt count
+	TR_VIEW_COMMON
+	uint8_t	 common_preempt_lazy_count;
+	uint8_t	 pad1[3];
+	char	 prev_comm[16];
+	pid_t	 prev_pid;
+	int32_t	 prev_prio;
+	uint8_t	 pad2[4];
+	uint64_t prev_state;
+	char	 next_comm[16];
+	pid_t	 next_pid;
+	int32_t	 next_prio;
+} __attribute__((packed));
+
+struct tr_wakeup_view {		// mainline 4.x-6.x
+	TR_VIEW_COMMON
+	char	 comm[16];
+	pid_t	 pid;
+	int32_t	 prio;
+	int32_t	 target_cpu;
+} __attribute__((packed));
+
+struct tr_wakeup_view_rt {	// PREEMPT_RT, lazy preempt count
+	TR_VIEW_COMMON
+	uint8_t	 common_preempt_lazy_count;
+	uint8_t	 pad1[3];
+	char	 comm[16];
+	pid_t	 pid;
+	int32_t	 prio;
+	int32_t	 target_cpu;
+} __attribute__((packed));
+
+// field name, offset and size a format must have to use a view
+struct tr_viewfield {
+	const char * name;
+	int offset;
+	int size;
+};
+#define TR_VIEWFIELD(view, field) { #field, offsetof(view, field), sizeof(((view *)0)->field) }
+
+#define TR_COMMON_FIELDS(view) \
+	TR_VIEWFIELD(view, common_type), TR_VIEWFIELD(view, common_flags), \
+	TR_VIEWFIELD(view, common_preempt_count), TR_VIEWFIELD(view, common_pid)
+#define TR_SWITCH_FIELDS(view) TR_COMMON_FIELDS(view), \
+	TR_VIEWFIELD(view, prev_comm), TR_VIEWFIELD(view, prev_pid), TR_VIEWFIELD(view, prev_prio), \
+	TR_VIEWFIELD(view, prev_state), TR_VIEWFIELD(view, next_comm), TR_VIEWFIELD(view, next_pid), \
+	TR_VIEWFIELD(view, next_prio)
+#define TR_WAKEUP_FIELDS(view) TR_COMMON_FIELDS(view), \
+	TR_VIEWFIELD(view, comm), TR_VIEWFIELD(view, pid), TR_VIEWFIELD(view, prio), \
+	TR_VIEWFIELD(view, target_cpu)
+
+static const struct tr_viewfield tr_common_vfld[] = { TR_COMMON_FIELDS(struct tr_common_view), { NULL, 0, 0 } };
+static const struct tr_viewfield tr_switch_vfld[] = { TR_SWITCH_FIELDS(struct tr_switch_view), { NULL, 0, 0 } };
+static const struct tr_viewfield tr_switch_vfld_rt[] = { TR_SWITCH_FIELDS(struct tr_switch_view_rt), { NULL, 0, 0 } };
+static const struct tr_viewfield tr_wakeup_vfld[] = { TR_WAKEUP_FIELDS(struct tr_wakeup_view), { NULL, 0, 0 } };
+static const struct tr_viewfield tr_wakeup_vfld_rt[] = { TR_WAKEUP_FIELDS(struct tr_wakeup_view_rt), { NULL, 0, 0 } };
+
+// layouts selected by parseEventOffsets()
+static enum tr_layout tr_common_lay = trl_offset;
+static enum tr_layout tr_switch_lay = trl_offset;
+static enum tr_layout tr_wakeup_lay = trl_offset;
+
+// Decoded events, values read once from the ring-buffer
+struct tr_switch_rec {
+	const char * prev_comm;
+	pid_t	 prev_pid;
+	int32_t	 prev_prio;
+	uint64_t prev_state;
+	const char * next_comm;
+	pid_t	 next_pid;
+	int32_t	 next_prio;
+};
+
+struct tr_wakeup_rec {
+	const char * comm;
+	pid_t	 pid;
+	int32_t	 prio;
+	int32_t	 target_cpu;
+};
 
 // these are data and name dictionaries used for parsing
 const char * const * const tr_event_dict [] = { tr_common_dict, tr_switch_dict, tr_wakeup_dict, NULL };
@@ -136,14 +361,26 @@ const void * const tr_event_structs [] = { &tr_common, &tr_switch, &tr_wakeup, N
 static volatile sig_atomic_t ftrace_stop;
 
 void *thread_ftrace(void *arg);
+static void *thread_ftrace_pool(void *arg);
 
 // functions to elaborate data for tracer frames
-static int pickPidCommon(const void * addr, const struct ftrace_thread * fthread, uint64_t ts);
-static int pickPidInfoS(const void * addr, const struct ftrace_thread * fthread, uint64_t ts);
-static int pickPidInfoW(const void * addr, const struct ftrace_thread * fthread, uint64_t ts);
+static int pickPidCommon_u(const void * addr, const struct ftrace_thread * fthread, uint64_t ts);
+static int pickPidInfoS_u(const void * addr, const struct ftrace_thread * fthread, uint64_t ts);
+static int pickPidInfoW_u(const void * addr, const struct ftrace_thread * fthread, uint64_t ts);
 
 static int get_sched_info(node_t * item);
 
+// traced events, handlers and PID fields for the kernel-side filter
+static const struct {
+	char * event;
+	ftrace_call_t eventcall;
+	const char * const * fltfields;
+} tr_events[] = {
+	{ TR_EVENT_SWITCH, pickPidInfoS_u, tr_switch_flt },
+	{ TR_EVENT_WAKEUP, pickPidInfoW_u, tr_wakeup_flt },
+	{ NULL, NULL, NULL }
+};
+
 /*
  *  ftrace_inthand(): interrupt handler for infinite while loop, help
  *  this function is called from outside, interrupt handling routine
@@ -157,6 +394,57 @@ ftrace_inthand (int sig, siginfo_t *siginfo, void *context){
 	ftrace_stop = 1;
 }
 
+/*
+ *  checkEventView(): verify that a parsed event format matches a view
+ *
+ *  Arguments: - event with parsed field configuration
+ *  		   - view fields, NULL-name terminated
+ *
+ *  Return value: 1 if all fields match in offset and size, 0 otherwise
+ */
+static int
+checkEventView(const struct ftrace_elist * event, const struct tr_viewfield * vfld){
+	for (; (vfld->name); vfld++){
+		struct ftrace_ecfg * cfg = event->fields;
+		while ((cfg) && strcmp(cfg->name, vfld->name))
+			cfg = cfg->next;
+		if (!cfg || cfg->offset != vfld->offset || cfg->size != vfld->size)
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ *  selectEventViews(): select packed views for the loaded event formats,
+ *  				events of unknown layout keep using the parsed offsets
+ *
+ *  Arguments: - ( global event list is used )
+ *
+ *  Return value: -
+ */
+static void
+selectEventViews(){
+	tr_common_lay = trl_std;
+	tr_switch_lay = trl_offset;
+	tr_wakeup_lay = trl_offset;
+
+	for (struct ftrace_elist * event = elist_head; (event); event=event->next){
+		// common header is read for all events
+		if (!checkEventView(event, tr_common_vfld))
+			tr_common_lay = trl_offset;
+
+		if (!strcmp(event->event, TR_EVENT_SWITCH))
+			tr_switch_lay = checkEventView(event, tr_switch_vfld) ? trl_std
+							: checkEventView(event, tr_switch_vfld_rt) ? trl_rt : trl_offset;
+		else if (!strcmp(event->event, TR_EVENT_WAKEUP))
+			tr_wakeup_lay = checkEventView(event, tr_wakeup_vfld) ? trl_std
+							: checkEventView(event, tr_wakeup_vfld_rt) ? trl_rt : trl_offset;
+	}
+
+	printDbg(PFX "Event layouts common %d, switch %d, wakeup %d (0 = offsets)\n",
+			tr_common_lay, tr_switch_lay, tr_wakeup_lay);
+}
+
 /*
  *  parseEventOffsets(): store field offsets into structs (ftrace)
  *				this function puts field offsets to known trace
@@ -207,6 +495,9 @@ parseEventOffsets(){
 		}
 	}
 
+	if (!cmn)
+		selectEventViews();
+
 	return -cmn;	// at least common has been parsed?
 }
 
@@ -362,53 +653,469 @@ parseEventFields(struct ftrace_ecfg ** ecfg, char * buffer){
 }
 
 /*
- *  appendEvent(): add an event to event list to watch (fTrace)
+ *  setEventCall(): register event handler in the dispatch table (fTrace)
+ *
+ *  Arguments: - kernel event ID, 16 bit
+ *  		   - function (pointer) to call for the event
+ *
+ *  Return value: 0 on success, -1 on error
+ */
+static int
+setEventCall(int eventid, ftrace_call_t fun){
+
+	if (0 > eventid || UINT16_MAX < eventid)
+		return -1;
+
+	if (eventid >= elist_dispsz){
+		// grow table, new entries are skipped types
+		ftrace_call_t * disp = realloc(elist_disp, sizeof(ftrace_call_t) * (eventid+1));
+		if (!disp)
+			err_exit("could not allocate memory!");
+		(void)memset(disp + elist_dispsz, 0, sizeof(ftrace_call_t) * (eventid+1-elist_dispsz));
+		elist_disp = disp;
+		elist_dispsz = eventid+1;
+	}
+
+	elist_disp[eventid] = fun;
+	return 0;
+}
+
+/*
+ *  addEvent(): add an event and its handler to the event list
+ *
+ *  Arguments: - event name (path)
+ *  		   - event kernel ID
+ *  		   - function (pointer) to call for the event
+ *  		   - PID fields for the kernel-side filter, NULL = none
+ *  		   - event format description, null terminated
+ *
+ *  Return value: 0 on success, -1 on error
+ */
+static int
+addEvent(const char * event, int eventid, ftrace_call_t fun,
+		const char * const * fltfields, char * format){
+
+	push((void**)&elist_head, sizeof(struct ftrace_elist));
+	elist_head->eventid = eventid;
+	elist_head->event = strdup(event);
+	elist_head->eventcall = fun;
+	elist_head->fltfields = fltfields;
+
+	if (setEventCall(elist_head->eventid, fun)){
+		warn("Invalid event id for '%s'", event);
+		return -1;
+	}
+
+	if (parseEventFields(&elist_head->fields, format))
+		warn("Unable to parse event format for '%s'", event);
+
+	return 0;
+}
+
+/*
+ *  appendEvent(): enable a kernel event and add it to event list to watch (fTrace)
  *
  *  Arguments: - debug path prefix
  *  		   - event name (path)
  *  		   - function (pointer) to call for the event
+ *  		   - PID fields for the kernel-side filter, NULL = none
  *
  *  Return value: 0 on success, -1 on error
  */
 static int
-appendEvent(char * dbgpfx, char * event, void* fun ){
+appendEvent(char * dbgpfx, char * event, ftrace_call_t fun, const char * const * fltfields){
 
 	char path[_POSIX_PATH_MAX];
 	(void)sprintf(path, "%sevents/%s/", dbgpfx, event);
 
-	// maybe put it in a function??
-	if (0 < setkernvar(path, "enable", "1", prgset->dryrun & MSK_DRYNOTRCNG)) {
-		push((void**)&elist_head, sizeof(struct ftrace_elist));
-		{
-			char val[5];
-			if ( 0 < getkernvar(path, "id", val, 5))
-				elist_head->eventid = atoi(val);
-			else{
-				warn("Unable to get event id '%s'", event);
-				return -1;
-			}
+	if (0 >= setkernvar(path, "enable", "1", prgset->dryrun & MSK_DRYNOTRCNG)) {
+		warn("Unable to set event for '%s'", event);
+		return -1;
+	}
+
+	char val[6];
+	if ( 0 >= getkernvar(path, "id", val, sizeof(val))){
+		warn("Unable to get event id '%s'", event);
+		return -1;
+	}
+
+	char buf[PIPE_BUFFER];
+	if ( 0 >= getkernvar(path, "format", buf, sizeof(buf))){
+		warn("Unable to get event format for '%s'", event);
+		return -1;
+	}
+
+	return addEvent(event, atoi(val), fun, fltfields, buf);
+}
+
+/*
+ *  openTraceFile(): open a file of a trace record directory
+ *
+ *  Arguments: - record directory
+ *  		   - fopen mode
+ *  		   - file name format, printf style, and arguments
+ *
+ *  Return value: file stream, NULL on error
+ */
+static FILE *
+openTraceFile(const char * dir, const char * mode, const char * fmt, ...){
+	char fn[_POSIX_PATH_MAX];
+	va_list ap;
+
+	int len = snprintf(fn, sizeof(fn), "%s/", dir);
+	va_start(ap, fmt);
+	(void)vsnprintf(fn + len, sizeof(fn) - len, fmt, ap);
+	va_end(ap);
+
+	return fopen(fn, mode);
+}
+
+/*
+ *  recordTraceMeta(): write event IDs, formats and traced CPUs to the
+ *  				trace record directory
+ *
+ *  Arguments: - debug path prefix
+ *
+ *  Return value: 0 on success, -1 on error
+ */
+static int
+recordTraceMeta(char * dbgpfx){
+	FILE * f;
+
+	if (mkdir(prgset->trace_rec, 0755) && EEXIST != errno){
+		warn("Unable to create trace record directory '%s': %s", prgset->trace_rec, strerror(errno));
+		return -1;
+	}
+
+	if (!(f = openTraceFile(prgset->trace_rec, "w", TR_REC_EVENTS)))
+		goto error;
+
+	for (struct ftrace_elist * event = elist_head; (event); event=event->next){
+		char path[_POSIX_PATH_MAX];
+		char buf[PIPE_BUFFER];
+		FILE * ff;
+
+		(void)fprintf(f, "%d %s\n", event->eventid, event->event);
+
+		(void)sprintf(path, "%sevents/%s/", dbgpfx, event->event);
+		if (0 >= getkernvar(path, "format", buf, sizeof(buf))
+				|| !(ff = openTraceFile(prgset->trace_rec, "w", TR_REC_FORMAT, event->eventid))){
+			(void)fclose(f);
+			goto error;
 		}
-		elist_head->event = strdup(event);
-		elist_head->eventcall = fun;
+		(void)fputs(buf, ff);
+		(void)fclose(ff);
+	}
+	(void)fclose(f);
 
-		{
-			char buf[PIPE_BUFFER];
-			if ( 0 < getkernvar(path, "format", buf, sizeof(buf))){
-				if (parseEventFields(&elist_head->fields, buf))
-					warn("Unable to parse event format for '%s'", event);
-			}
-			else{
-				warn("Unable to get event format for '%s'", event);
+	if (!(f = openTraceFile(prgset->trace_rec, "w", TR_REC_CPUS)))
+		goto error;
+	for (int i=0; i<prgset->affinity_mask->size; i++)
+		if (numa_bitmask_isbitset(prgset->affinity_mask, i))
+			(void)fprintf(f, "%d\n", i);
+	(void)fclose(f);
+
+	return 0;
+
+error:
+	warn("Unable to write trace record to '%s'", prgset->trace_rec);
+	return -1;
+}
+
+/*
+ *  loadTraceMeta(): setup events from a trace record directory, replay
+ *
+ *  Arguments: - none
+ *
+ *  Return value: 0 on success, -1 on error
+ */
+static int
+loadTraceMeta(){
+	FILE * f;
+	int ret = 0;
+	int eventid;
+	char event[CMD_LEN];
+
+	if (!(f = openTraceFile(prgset->trace_play, "r", TR_REC_EVENTS))){
+		warn("Unable to read recorded events from '%s'", prgset->trace_play);
+		return -1;
+	}
+
+	while (2 == fscanf(f, "%d %127s", &eventid, event)){
+		int i;
+		for (i=0; (tr_events[i].event) && strcmp(tr_events[i].event, event); i++);
+		if (!tr_events[i].event){
+			printDbg(PFX "Skipping recorded event '%s'\n", event);
+			continue;
+		}
+
+		char buf[PIPE_BUFFER];
+		size_t len = 0;
+		FILE * ff = openTraceFile(prgset->trace_play, "r", TR_REC_FORMAT, eventid);
+		if (ff){
+			len = fread(buf, 1, sizeof(buf)-1, ff);
+			(void)fclose(ff);
+		}
+		if (!len){
+			warn("Unable to read recorded format for '%s'", event);
+			ret = -1;
+			break;
+		}
+		buf[len] = '\0';
+
+		// no kernel-side filter, data is recorded
+		if ((ret = addEvent(event, eventid, tr_events[i].eventcall, NULL, buf)))
+			break;
+	}
+	(void)fclose(f);
+
+	if (!ret && !elist_head){
+		warn("No known events in trace record '%s'", prgset->trace_play);
+		ret = -1;
+	}
+
+	return (ret) ? ret : parseEventOffsets();
+}
+
+/*
+ *  getPidRanges_u(): collect tracked PIDs as ranges of consecutive PIDs,
+ *  					dataMutex must be held
+ *
+ *  Arguments: - pointer to range array, resized as needed
+ *  		   - pointer to array size (elements)
+ *
+ *  Return value: number of ranges found
+ */
+static int
+getPidRanges_u(struct tr_pidrange ** rng, int * rngsz){
+	int cnt = 0;
+
+	// list is sorted descending, threads of a container are often consecutive
+	for (node_t * item = nhead; ((item)); item=item->next ) {
+		if (0 >= item->pid)	// deactivated or undefined
+			continue;
+
+		if ((cnt) && ((*rng)[cnt-1].lo - 1 == item->pid)){
+			(*rng)[cnt-1].lo = item->pid;
+			continue;
+		}
+
+		if (cnt >= *rngsz){
+			*rngsz = (*rngsz) ? *rngsz * 2 : 16;
+			if (!(*rng = realloc(*rng, sizeof(struct tr_pidrange) * *rngsz)))
+				err_exit("could not allocate memory!");
+		}
+		(*rng)[cnt].lo = item->pid;
+		(*rng)[cnt].hi = item->pid;
+		cnt++;
+	}
+
+	return cnt;
+}
+
+/*
+ *  getEventFilter(): compose a kernel event filter matching a PID set
+ *
+ *  Arguments: - buffer for the filter expression
+ *  		   - buffer size
+ *  		   - PID fields of the event, NULL terminated
+ *  		   - PID ranges to match
+ *  		   - number of ranges
+ *
+ *  Return value: length of the expression, -1 if it does not fit
+ */
+static int
+getEventFilter(char * buf, size_t size, const char * const * fields,
+		const struct tr_pidrange * rng, int cnt){
+	size_t len = 0;
+
+	if (!cnt){	// nothing tracked, let nothing through
+		int ret = snprintf(buf, size, "%s<0", *fields);
+		return (0 > ret || (size_t)ret >= size) ? -1 : ret;
+	}
+
+	for (const char * const * fld = fields; (*fld); fld++)
+		for (int i = 0; i < cnt; i++){
+			const char * sep = (len) ? "||" : "";
+			int ret;
+			if (rng[i].lo == rng[i].hi)
+				ret = snprintf(buf + len, size - len, "%s%s==%d", sep, *fld, rng[i].lo);
+			else
+				ret = snprintf(buf + len, size - len, "%s(%s>=%d&&%s<=%d)",
+						sep, *fld, rng[i].lo, *fld, rng[i].hi);
+			if (0 > ret || (size_t)ret >= size - len)
 				return -1;
-			}
+			len += ret;
 		}
 
+	return (int)len;
+}
+
+/*
+ *  updateTraceFilters(): synchronize kernel-side event filters with the
+ *  					tracked PID set, if it changed since the last call
+ *
+ *  Arguments: - none
+ *
+ *  Return value: 0 = success or no change, -1 = error writing a filter
+ */
+static int
+updateTraceFilters(){
+	static struct tr_pidrange * rng = NULL;
+	static int rngsz = 0;
+	int ret = 0;
+
+	// lock data to avoid inconsistency
+	(void)pthread_mutex_lock(&dataMutex);
+	int64_t gen = node_idxGen();
+	if (gen == elist_fltgen){
+		(void)pthread_mutex_unlock(&dataMutex);
 		return 0;
 	}
+	int cnt = getPidRanges_u(&rng, &rngsz);
+	(void)pthread_mutex_unlock(&dataMutex);
+
+	char * dbgpfx = get_debugfileprefix();
+	char path[_POSIX_PATH_MAX];
+	char * buf = malloc(TR_FILTER_MAX+1);
+	if (!buf)
+		err_exit("could not allocate memory!");
 
-	warn("Unable to set event for '%s'", event);
+	for (struct ftrace_elist * event = elist_head; (event); event=event->next){
+		if (!event->fltfields)
+			continue;
 
-	return -1;
+		// too many PIDs for the kernel, clear the filter and sort in user-space
+		if (0 > getEventFilter(buf, TR_FILTER_MAX+1, event->fltfields, rng, cnt)){
+			printDbg(PFX "PID filter for '%s' too long, disabled\n", event->event);
+			(void)strcpy(buf, "0");
+		}
+
+		(void)sprintf(path, "%sevents/%s/", dbgpfx, event->event);
+		if (0 > setkernvar(path, "filter", buf, prgset->dryrun & MSK_DRYNOTRCNG)){
+			warn("Unable to set kernel event filter for '%s'", event->event);
+			ret = -1;
+		}
+	}
+	free(buf);
+
+	// retry on next call if unsuccessful
+	if (!ret)
+		elist_fltgen = gen;
+
+	return ret;
+}
+
+/*
+ *  setTraceBuffer(): write the ring-buffer size of a traced CPU
+ *
+ *  Arguments: - fTrace thread info (CPU), size is updated on success
+ *  		   - new size in kB
+ *
+ *  Return value: 0 = success, -1 = error writing the size
+ */
+static int
+setTraceBuffer(struct ftrace_thread * fthread, int kb){
+	char path[_POSIX_PATH_MAX];
+	char val[16];
+
+	(void)sprintf(path, "%sper_cpu/cpu%d/", get_debugfileprefix(), fthread->cpuno);
+	(void)sprintf(val, "%d", kb);
+	// a memory mapped ring-buffer can not be resized, EBUSY
+	if (0 > setkernvar(path, "buffer_size_kb", val, prgset->dryrun & MSK_DRYNOTRCNG))
+		return -1;
+
+	printDbg(PFX "Ring-buffer of CPU%d resized %dkB -> %dkB\n", fthread->cpuno, fthread->bufkb, kb);
+	fthread->bufkb = kb;
+	return 0;
+}
+
+/*
+ *  updateTraceBuffer(): adapt the ring-buffer size of a traced CPU to its
+ *  					losses and fill level of the last period
+ *
+ *  Arguments: - fTrace thread info (CPU)
+ *
+ *  Return value: 0 = success or no change, -1 = error, sizing disabled for CPU
+ */
+static int
+updateTraceBuffer(struct ftrace_thread * fthread){
+
+	if (0 > fthread->bufkb)
+		return 0;	// fixed size
+
+	// read counters once, the readers keep updating them
+	uint64_t pages = atomic_load_explicit(&fthread->pages, memory_order_relaxed);
+	uint64_t missed = atomic_load_explicit(&fthread->missed, memory_order_relaxed);
+
+	if (!fthread->bufkb){
+		// first period, get size set at start as lower bound
+		char path[_POSIX_PATH_MAX];
+		char val[64];
+		(void)sprintf(path, "%sper_cpu/cpu%d/", get_debugfileprefix(), fthread->cpuno);
+		if (0 >= getkernvar(path, "buffer_size_kb", val, sizeof(val))
+				|| 0 >= (fthread->bufmin = atoi(val))){
+			printDbg(PFX "Unable to read ring-buffer size of CPU%d\n", fthread->cpuno);
+			fthread->bufkb = -1;
+			return -1;
+		}
+		fthread->bufkb = fthread->bufmin;
+		fthread->bufpages = pages;
+		fthread->bufmissed = missed;
+		return 0;
+	}
+
+	int kb = fthread->bufkb;
+	if (missed != fthread->bufmissed){
+		// losses, double up to limit
+		kb = MIN(kb * 2, TR_BUFMAX_KB);
+		fthread->bufquiet = 0;
+	}
+	else if ((pages - fthread->bufpages) * PIPE_BUFFER * TR_BUFLOWFILL < (uint64_t)kb * 1024){
+		// low fill, halve down to initial size after a while
+		if (TR_BUFQUIET <= ++fthread->bufquiet){
+			kb = MAX(kb / 2, fthread->bufmin);
+			fthread->bufquiet = 0;
+		}
+	}
+	else
+		fthread->bufquiet = 0;
+
+	fthread->bufpages = pages;
+	fthread->bufmissed = missed;
+
+	if (kb != fthread->bufkb && setTraceBuffer(fthread, kb)){
+		printDbg(PFX "Unable to resize ring-buffer of CPU%d, keeping %dkB\n", fthread->cpuno, fthread->bufkb);
+		fthread->bufkb = -1;
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ *  updateTraceBuffers(): adapt ring-buffer sizes of all traced CPUs, once
+ *  					per evaluation period
+ *
+ *  Arguments: - none
+ *
+ *  Return value: 0 = success, -1 = error resizing a buffer
+ */
+static int
+updateTraceBuffers(){
+	static int cycle = 0;
+	int ret = 0;
+
+	if (prgset->trace_play)	// offline, no kernel buffers
+		return 0;
+
+	if (++cycle < MAX(1, TR_BUFPERIOD / prgset->interval))
+		return 0;
+	cycle = 0;
+
+	for (struct ftrace_thread * fthread = elist_thead; ((fthread)); fthread=fthread->next)
+		ret |= updateTraceBuffer(fthread);
+
+	return ret;
 }
 
 /*
@@ -421,6 +1128,9 @@ appendEvent(char * dbgpfx, char * event, void* fun ){
 static int
 configureTracers(){
 
+	if (prgset->trace_play)	// offline, recorded events
+		return loadTraceMeta();
+
 	char * dbgpfx = get_debugfileprefix();
 
 	if (!dbgpfx)
@@ -445,15 +1155,23 @@ configureTracers(){
 			warn("can not obtain HEX CPU mask");
 	}
 
-	if ((appendEvent(dbgpfx, TR_EVENT_SWITCH, pickPidInfoS)))
-		return -1;
+	// wake pollers of the raw pipes on any data, not when half full
+	if ( 0 > setkernvar(dbgpfx, "buffer_percent", "0", prgset->dryrun & MSK_DRYNOTRCNG))
+		printDbg(PFX "Unable to set trace buffer wake-up threshold\n");
 
-	if ((appendEvent(dbgpfx, TR_EVENT_WAKEUP, pickPidInfoW)))
-		return -1;
+	for (int i=0; (tr_events[i].event); i++)
+		if ((appendEvent(dbgpfx, tr_events[i].event, tr_events[i].eventcall, tr_events[i].fltfields)))
+			return -1;
+
+	// filters are written with the first PID set update
+	elist_fltgen = -1;
 
 	if ((parseEventOffsets()))
 		return -1;
 
+	if ((prgset->trace_rec) && (recordTraceMeta(dbgpfx)))
+		return -1;
+
 	if ( 0 > setkernvar(dbgpfx, "tracing_on", "1", prgset->dryrun & MSK_DRYNOTRCNG)){
 		warn("Can not enable kernel function tracing");
 		return -1;
@@ -473,16 +1191,31 @@ static void
 resetTracers(){
 	char * dbgpfx = get_debugfileprefix();
 
+	if (prgset->trace_play)	// offline, nothing set in kernel
+		goto clear;
+
 	if ( 0 > setkernvar(dbgpfx, "tracing_on", "0", prgset->dryrun & MSK_DRYNOTRCNG))
 		warn("Can not disable kernel function tracing");
 
 	if (0 > setkernvar(dbgpfx, "events/enable", "0", prgset->dryrun & MSK_DRYNOTRCNG))
 		warn("Unable to clear kernel fTrace event list");
 
+	// filters persist in the kernel, clear them
+	for (struct ftrace_elist * event = elist_head; (event); event=event->next){
+		if (!event->fltfields)
+			continue;
+		char path[_POSIX_PATH_MAX];
+		(void)sprintf(path, "%sevents/%s/", dbgpfx, event->event);
+		if (0 > setkernvar(path, "filter", "0", prgset->dryrun & MSK_DRYNOTRCNG))
+			warn("Unable to clear kernel event filter for '%s'", event->event);
+	}
+	elist_fltgen = -1;
+
 	// sched_stat_runtime tracer seems to need sched_stats
 	if (0 > setkernvar(prgset->procfileprefix, "sched_schedstats", "0", prgset->dryrun & MSK_DRYNOTRCNG))
 		warn("Unable to deactivate schedstat probe");
 
+clear:
 	while (elist_head){
 		free(elist_head->event);
 		while (elist_head->fields){
@@ -491,10 +1224,117 @@ resetTracers(){
 		}
 		pop((void**)&elist_head);
 	}
+
+	free(elist_disp);
+	elist_disp = NULL;
+	elist_dispsz = 0;
 }
 
 /*
- *  startTraceRead(): start CPU tracing threads
+ *  startTraceReadPool(): start pool of tracing threads, pinned to system CPUs
+ *
+ *  Arguments: - number of reader threads
+ *
+ *  Return value: OR-result of pthread_create, negative if one failed
+ */
+static int
+startTraceReadPool(int readers) {
+
+	int maxcpu = prgset->affinity_mask->size;
+	int ret = 0;
+	int cnt = 0;
+
+	// CPU list, not started
+	for (int i=maxcpu-1;i>=0;i--)
+		if (numa_bitmask_isbitset(prgset->affinity_mask, i)){ // filter by active
+			push((void**)&elist_thead, sizeof(struct ftrace_thread));
+			elist_thead->cpuno = i;
+			elist_thead->dbgfile = NULL;
+			elist_thead->iret = -1; // served by reader pool
+			cnt++;
+		}
+
+	if (!cnt)
+		return 0;
+	readers = MIN(readers, cnt);
+
+	// system CPUs, where the orchestrator runs (not RT partition)
+	struct bitmask * sysmask = numa_allocate_cpumask();
+	int syscpus[maxcpu];
+	int nsys = 0;
+	if (!numa_sched_getaffinity(0, sysmask))
+		for (int i=0; i<maxcpu; i++)
+			if (numa_bitmask_isbitset(sysmask, i)
+					&& !numa_bitmask_isbitset(prgset->affinity_mask, i))
+				syscpus[nsys++] = i;
+	numa_free_cpumask(sysmask);
+
+	if (!nsys)
+		warn("No system CPUs to pin fTrace readers to");
+
+	for (int r=0; r<readers; r++){
+		push((void**)&elist_rhead, sizeof(struct ftrace_reader));
+		elist_rhead->cpuno = (nsys) ? syscpus[r % nsys] : -1;
+		elist_rhead->fthreads = malloc(sizeof(struct ftrace_thread *) * (cnt / readers + 1));
+		if (!elist_rhead->fthreads)
+			err_exit("could not allocate memory!");
+
+		// distribute CPUs round robin
+		int k = 0;
+		for (struct ftrace_thread * fthread = elist_thead; ((fthread)); fthread=fthread->next, k++)
+			if (r == k % readers)
+				elist_rhead->fthreads[elist_rhead->cnt++] = fthread;
+
+		elist_rhead->iret = pthread_create( &elist_rhead->thread, NULL, thread_ftrace_pool, elist_rhead);
+#ifdef DEBUG
+		char tname [17]; // 16 char length restriction
+		(void)sprintf(tname, "manage_ftRdr%d", r); // space for 4 digit reader number
+		(void)pthread_setname_np(elist_rhead->thread, tname);
+#endif
+		ret |= elist_rhead->iret; // combine results in OR to detect one failing
+	}
+
+	return ret; // = 0 if OK, else negative
+}
+
+/*
+ *  startTraceReplay(): start CPU tracing threads reading a trace record
+ *
+ *  Arguments: -
+ *
+ *  Return value: OR-result of pthread_create, negative if one failed
+ */
+static int
+startTraceReplay() {
+
+	FILE * f;
+	int ret = 0;
+	int cpu;
+
+	if (!(f = openTraceFile(prgset->trace_play, "r", TR_REC_CPUS))){
+		warn("Unable to read recorded CPUs from '%s'", prgset->trace_play);
+		return -1;
+	}
+
+	replay_limit = 0;
+	while (1 == fscanf(f, "%d", &cpu)){
+		push((void**)&elist_thead, sizeof(struct ftrace_thread));
+		elist_thead->cpuno = cpu;
+		if (!(elist_thead->dbgfile = malloc(_POSIX_PATH_MAX)))
+			err_exit("could not allocate memory!");
+		(void)snprintf(elist_thead->dbgfile, _POSIX_PATH_MAX, "%s/" TR_REC_PAGES, prgset->trace_play, cpu);
+		elist_thead->iret = pthread_create( &elist_thead->thread, NULL, thread_ftrace, elist_thead);
+		if (elist_thead->iret)
+			elist_thead->ts = REPLAY_DONE; // do not wait for it
+		ret |= elist_thead->iret; // combine results in OR to detect one failing
+	}
+	(void)fclose(f);
+
+	return ret; // = 0 if OK, else negative
+}
+
+/*
+ *  startTraceRead(): start CPU tracing threads
  *
  *  Arguments:
  *
@@ -503,6 +1343,12 @@ resetTracers(){
 static int
 startTraceRead() {
 
+	if (prgset->trace_play)
+		return startTraceReplay();
+
+	if (0 < prgset->ftrace_rdrs)
+		return startTraceReadPool(prgset->ftrace_rdrs);
+
 	int maxcpu = prgset->affinity_mask->size;
 	int ret = 0;
 	// loop through, bit set = start a thread and store in ll
@@ -523,6 +1369,38 @@ startTraceRead() {
 	return ret; // = 0 if OK, else negative
 }
 
+/*
+ *  stopTraceThread(): stop a tracing thread and wait for it to exit
+ *
+ *  Arguments: - thread to stop
+ *
+ *  Return value: OR-result of pthread_*, negative if one failed
+ */
+static int
+stopTraceThread(pthread_t thread) {
+
+	int ret = 0;
+	void * retVal = NULL;
+
+	int ret1 = 0;
+	if ((ret1 = pthread_kill (thread, SIGQUIT))) // tell threads to stop
+		err_msg_n(ret1, "Failed to send signal to fTrace thread");
+	ret |= ret1; // combine results in OR to detect one failing
+
+	if ((ret1 = pthread_join( thread, &retVal))) // wait until end
+		err_msg_n(ret1, "Could not join with fTrace thread");
+	ret |= ret1; // combine results in OR to detect one failing
+
+	if (retVal){ // return value assigned
+		ret |= *(int*)retVal;
+		if (*(int*)retVal)
+			err_msg_n(*(int*)retVal, "fTrace thread exited");
+		free (retVal); // free heap space of return value
+	}
+
+	return ret;
+}
+
 /*
  *  stopTraceRead(): stop CPU tracing threads
  *
@@ -534,29 +1412,28 @@ static int
 stopTraceRead() {
 
 	int ret = 0;
-	void * retVal = NULL;
+	// loop through existing readers of the pool, and join
+	while ((elist_rhead)){
+		if (!elist_rhead->iret) // thread started successfully
+			ret |= stopTraceThread(elist_rhead->thread);
+
+		free(elist_rhead->fthreads);
+		pop((void**)&elist_rhead);
+	}
+
 	// loop through, existing list elements, and join
-	while ((elist_thead))
-		if (!elist_thead->iret) { // thread started successfully
-
-			int ret1 = 0;
-			if ((ret1 = pthread_kill (elist_thead->thread, SIGQUIT))) // tell threads to stop
-				err_msg_n(ret1, "Failed to send signal to fTrace thread");
-			ret |= ret1; // combine results in OR to detect one failing
-
-			if ((ret1 = pthread_join( elist_thead->thread, &retVal))) // wait until end
-				err_msg_n(ret1, "Could not join with fTrace thread");
-			ret |= ret1 | *(int*)retVal; // combine results in OR to detect one failing
-
-			if (retVal){ // return value assigned
-				if (*(int*)retVal)
-					err_msg_n(*(int*)retVal, "fTrace thread exited");
-				free (retVal); // free heap space of return value
-			}
+	while ((elist_thead)){
+		if (!elist_thead->iret) // thread started successfully
+			ret |= stopTraceThread(elist_thead->thread);
 
-			free(elist_thead->dbgfile); // free it if defined
-			pop((void**)&elist_thead);
-		}
+		// restore ring-buffer size found at start
+		if (0 < elist_thead->bufkb && elist_thead->bufkb != elist_thead->bufmin
+				&& setTraceBuffer(elist_thead, elist_thead->bufmin))
+			warn("Unable to restore ring-buffer size of CPU%d", elist_thead->cpuno);
+
+		free(elist_thead->dbgfile); // free it if defined
+		pop((void**)&elist_thead);
+	}
 	return ret; // >= 0 if OK, else negative
 }
 
@@ -583,19 +1460,19 @@ pidReallocAndTest(resTracer_t * ntrc, resTracer_t * trc, node_t * node){
 				if (0 < item->pid && item->param && item->param->cont
 						&& item->param->cont == node->param->cont){
 
-					item->mon.assigned = getTracerMainCPU(ntrc);
+					(void)assignPidCPU(item, getTracerMainCPU(ntrc));
 					if (!setPidAffinityAssinged (item)){
 						item->mon.resched++;
 						continue;
 					}
 					if (trc){ // Reallocate did not work, undo if possible
-						item->mon.assigned = getTracerMainCPU(trc);
+						(void)assignPidCPU(item, getTracerMainCPU(trc));
 						for (node_t * bitem = nhead; ((bitem)) && bitem != item; bitem=bitem->next)
-							if (0 < bitem->pid && bitem->param && bitem->param->cont
-									&& bitem->param->cont == item->param->cont){
-								bitem->mon.assigned = getTracerMainCPU(trc);
-								(void)setPidAffinityAssinged (bitem);
-							}
+						if (0 < bitem->pid && bitem->param && bitem->param->cont
+								&& bitem->param->cont == item->param->cont){
+							(void)assignPidCPU(bitem, getTracerMainCPU(trc));
+							(void)setPidAffinityAssinged (bitem);
+						}
 					}
 					return -1;
 				}
@@ -620,14 +1497,30 @@ static int
 pickPidReallocCPU(int32_t CPUno, uint64_t deadline){
 	resTracer_t * trc = getTracer(CPUno);
 	resTracer_t * ntrc = NULL;
+	int cnt = 0;
+
+	if (!trc)
+		return -1;
+
+	// candidates of this CPU only, moves change the task list of the tracer
+	for (node_t * item = trc->tasks; ((item)); item = item->mon.tnext)
+		cnt++;
+	if (!cnt)
+		return -1; // nothing to move
+	node_t * items[cnt];
+	cnt = 0;
+	for (node_t * item = trc->tasks; ((item)); item = item->mon.tnext)
+		if (item->mon.assigned == CPUno && 0 <= item->pid
+				// consider only within next period
+			&& (!(deadline) || item->mon.deadline < deadline))
+			items[cnt++] = item;
 
 	for (int include = 0; include < 2; include++ )
 		// run twice, include=0 and include=1 to force move second time
-		for (node_t * item = nhead; ((item)); item=item->next){
-			if (item->mon.assigned != CPUno || 0 > item->pid
-					// consider only within next period
-				|| ((deadline) && item->mon.deadline >= deadline))
-				continue;
+		for (int i = 0; i < cnt; i++) {
+			node_t * item = items[i];
+			if (item->mon.assigned != CPUno)
+				continue; // moved with its container
 
 			ntrc = checkPeriod_R(item, include);
 			if (!pidReallocAndTest(ntrc, trc, item))
@@ -650,8 +1543,11 @@ pickPidCheckBuffer(node_t * item, uint64_t ts, uint64_t extra_rt){
 
 	uint64_t usedtime = 0;
 
-	// find all matching, test if space is enough
-	for (node_t *citem = nhead; ((citem)); citem=citem->next){
+	if (!item->mon.trc)	// not accounted, CPU without tracer
+		return (item->mon.deadline < ts + extra_rt);
+
+	// find all matching on the same tracer, test if space is enough
+	for (node_t * citem = item->mon.trc->tasks; ((citem)); citem = citem->mon.tnext) {
 		if (citem->mon.assigned != item->mon.assigned || 0 > citem->pid)
 			continue;
 
@@ -827,8 +1723,101 @@ pickPidConsolidatePeriod(node_t *item, uint64_t ts){
 	}
 }
 
+// read an event field at its parsed offset
+#define TR_FIELD(addr, type, off)	(*(const type *)((const unsigned char *)(addr) + (intptr_t)(off)))
+
+#define TR_SWITCH_REC(rec, view) do { \
+		(rec)->prev_comm = (view)->prev_comm; \
+		(rec)->prev_pid = (view)->prev_pid; \
+		(rec)->prev_prio = (view)->prev_prio; \
+		(rec)->prev_state = (view)->prev_state; \
+		(rec)->next_comm = (view)->next_comm; \
+		(rec)->next_pid = (view)->next_pid; \
+		(rec)->next_prio = (view)->next_prio; \
+	} while (0)
+
+#define TR_WAKEUP_REC(rec, view) do { \
+		(rec)->comm = (view)->comm; \
+		(rec)->pid = (view)->pid; \
+		(rec)->prio = (view)->prio; \
+		(rec)->target_cpu = (view)->target_cpu; \
+	} while (0)
+
+/*
+ *  getCommonRec(): read the common header of an event
+ *
+ *  Arguments: - frame address of the event
+ *  		   - common header values to fill
+ *
+ *  Return value: -
+ */
+static inline void
+getCommonRec(const void * addr, struct tr_common_view * rec){
+	if (trl_offset != tr_common_lay){
+		*rec = *(const struct tr_common_view *)addr;
+		return;
+	}
+	rec->common_type = TR_FIELD(addr, uint16_t, tr_common.common_type);
+	rec->common_flags = TR_FIELD(addr, uint8_t, tr_common.common_flags);
+	rec->common_preempt_count = TR_FIELD(addr, uint8_t, tr_common.common_preempt_count);
+	rec->common_pid = TR_FIELD(addr, int32_t, tr_common.common_pid);
+}
+
+/*
+ *  getSwitchRec(): read the fields of a sched_switch event
+ *
+ *  Arguments: - frame address of the event
+ *  		   - record to fill
+ *
+ *  Return value: -
+ */
+static inline void
+getSwitchRec(const void * addr, struct tr_switch_rec * rec){
+	switch (tr_switch_lay){
+	case trl_std:
+		TR_SWITCH_REC(rec, (const struct tr_switch_view *)addr);
+		break;
+	case trl_rt:
+		TR_SWITCH_REC(rec, (const struct tr_switch_view_rt *)addr);
+		break;
+	default:	// unknown layout, parsed offsets
+		rec->prev_comm = &TR_FIELD(addr, char, tr_switch.prev_comm);
+		rec->prev_pid = TR_FIELD(addr, pid_t, tr_switch.prev_pid);
+		rec->prev_prio = TR_FIELD(addr, int32_t, tr_switch.prev_prio);
+		rec->prev_state = TR_FIELD(addr, uint64_t, tr_switch.prev_state);
+		rec->next_comm = &TR_FIELD(addr, char, tr_switch.next_comm);
+		rec->next_pid = TR_FIELD(addr, pid_t, tr_switch.next_pid);
+		rec->next_prio = TR_FIELD(addr, int32_t, tr_switch.next_prio);
+	}
+}
+
+/*
+ *  getWakeupRec(): read the fields of a sched_wakeup event
+ *
+ *  Arguments: - frame address of the event
+ *  		   - record to fill
+ *
+ *  Return value: -
+ */
+static inline void
+getWakeupRec(const void * addr, struct tr_wakeup_rec * rec){
+	switch (tr_wakeup_lay){
+	case trl_std:
+		TR_WAKEUP_REC(rec, (const struct tr_wakeup_view *)addr);
+		break;
+	case trl_rt:
+		TR_WAKEUP_REC(rec, (const struct tr_wakeup_view_rt *)addr);
+		break;
+	default:	// unknown layout, parsed offsets
+		rec->comm = &TR_FIELD(addr, char, tr_wakeup.comm);
+		rec->pid = TR_FIELD(addr, pid_t, tr_wakeup.pid);
+		rec->prio = TR_FIELD(addr, int32_t, tr_wakeup.prio);
+		rec->target_cpu = TR_FIELD(addr, int32_t, tr_wakeup.target_cpu);
+	}
+}
+
 /*
- *  pickPidCommon(): process PID fTrace common header
+ *  pickPidCommon_u(): process PID fTrace common header, dataMutex must be held
  *
  *  Arguments: - frame address containing the runtime info
  *             - fTrace thread info
@@ -837,7 +1826,7 @@ pickPidConsolidatePeriod(node_t *item, uint64_t ts){
  *  Return value: error code, 0 = success
  */
 static int
-pickPidCommon(const void * addr, const struct ftrace_thread * fthread, uint64_t ts) {
+pickPidCommon_u(const void * addr, const struct ftrace_thread * fthread, uint64_t ts) {
 
 	//thread information flags, probable meaning
 	//#define FT_unknown 0x20 set on wakeup
@@ -846,37 +1835,26 @@ pickPidCommon(const void * addr, const struct ftrace_thread * fthread, uint64_t
 	//#define FT_needResched 0x4
 	//#define FT_irqoff 0x1
 
-	// use local copy and add addr's address with its offset
-	struct tr_common frame = tr_common;
-	// NOTE:  we inherit const void from addr
-	for (const void ** ptr = (void*)&frame; ptr < (const void **)(&frame + 1); ptr++)
-		// add addr
-		*ptr = addr + *(int32_t*)ptr;
+	struct tr_common_view frame;
+	getCommonRec(addr, &frame);
 
-	if (*frame.common_type & 0xF000)	// Malformed! type ~hundreds
+	if (frame.common_type & 0xF000)	// Malformed! type ~hundreds
 		return -1;
 
-	(void)pthread_mutex_lock(&dataMutex);
-
 	// find PID = actual running PID
-	for (node_t * item = nhead; ((item)); item=item->next )
-
-		if (item->pid == *frame.common_pid){
-			if (!(*frame.common_flags & 0x4)){ // = NEED_RESCHED requested by event on running task  = Task has to go online
-				item->status |=  MSK_STATNRSCH;
-			}
-		}
-	(void)pthread_mutex_unlock(&dataMutex);
+	node_t * item = node_idxGet(frame.common_pid);
+	if ((item) && !(frame.common_flags & 0x4)) // = NEED_RESCHED requested by event on running task  = Task has to go online
+		item->status |=  MSK_STATNRSCH;
 
 	// print here to have both line together
 	printStat( "[%lu.%09lu] type=%u flags=%x preempt=%u pid=%d\n", ts/NSEC_PER_SEC, ts%NSEC_PER_SEC,
-			*frame.common_type, *frame.common_flags, *frame.common_preempt_count, *frame.common_pid);
+			frame.common_type, frame.common_flags, frame.common_preempt_count, frame.common_pid);
 
 	return 0;
 }
 
 /*
- *  pickPidInfoS(): process PID fTrace sched_switch
+ *  pickPidInfoS_u(): process PID fTrace sched_switch, dataMutex must be held
  * 					update data with kernel tracer debug out
  *
  *  Arguments: - frame containing the runtime info
@@ -886,64 +1864,63 @@ pickPidCommon(const void * addr, const struct ftrace_thread * fthread, uint64_t
  *  Return value: error code, 0 = success
  */
 static int
-pickPidInfoS(const void * addr, const struct ftrace_thread * fthread, uint64_t ts) {
+pickPidInfoS_u(const void * addr, const struct ftrace_thread * fthread, uint64_t ts) {
 
-	if(pickPidCommon(addr, fthread, ts)) // malformed common?
+	if(pickPidCommon_u(addr, fthread, ts)) // malformed common?
 		return -1;
 
-	// use local copy and add addr's address with its offset
-	struct tr_switch frame = tr_switch;
-	// NOTE:  we inherit const void from addr
-	for (const void ** ptr = (void*)&frame; ptr < (const void **)(&frame + 1); ptr++)
-		// add addr
-		*ptr = addr + *(int32_t*)ptr;
+	struct tr_switch_rec frame;
+	getSwitchRec(addr, &frame);
 
 #ifdef DEBUG
 	char flags[10];
 
-	(void)get_status_flags(*frame.prev_state, flags, sizeof(flags));
+	(void)get_status_flags(frame.prev_state, flags, sizeof(flags));
 
 	printStat ("    prev_comm=%s prev_pid=%d prev_prio=%d prev_state=%s ==> next_comm=%s next_pid=%d next_prio=%d\n",
-				frame.prev_comm, *frame.prev_pid, *frame.prev_prio, flags,
-				frame.next_comm, *frame.next_pid, *frame.next_prio);
+				frame.prev_comm, frame.prev_pid, frame.prev_prio, flags,
+				frame.next_comm, frame.next_pid, frame.next_prio);
 #endif
 
 	if ((*frame.prev_comm & 0x80) || (*frame.next_comm & 0x80)) // malformed buffer? valid char?
 		return -1;
 
-	// lock data to avoid inconsistency
-	(void)pthread_mutex_lock(&dataMutex);
+	// find PIDs switching from and to, keep list order (descending PID)
+	node_t * prev = node_idxGet(frame.prev_pid);
+	node_t * next = node_idxGet(frame.next_pid);
+	node_t * items[2] = { prev, (next != prev) ? next : NULL };
+	if ((items[0]) && (items[1]) && items[1]->pid > items[0]->pid){
+		items[0] = next;
+		items[1] = prev;
+	}
 
-	// find PID switching from
-	for (node_t * item = nhead; ((item)); item=item->next ){
+	for (int i = 0; i < 2; i++){
+		node_t * item = items[i];
+		if (!item)
+			continue;
 
 		// previous or next pid in list, update data
-		if ((item->pid == *frame.prev_pid)
-				|| (item->pid == *frame.next_pid)){
-
-			// check if CPU changed, exiting
-			if (item->mon.assigned != fthread->cpuno){
-				// change on exit???, reassign CPU?
-				int32_t CPU = item->mon.assigned;
-				item->mon.assigned = fthread->cpuno;
-
-				if (0 <= CPU){
-					item->mon.resched++;
-
-					// Removed from old CPU, should give no issues
-					if (-1 == recomputeCPUTimes(CPU))	// if -2 = CPU not found, i.e. affinity preference, no real affinity set yet, do nothing
-						if (SM_DYNSIMPLE <= prgset->sched_mode)
-							(void)pickPidReallocCPU(CPU, 0);
-				}
-				else
-					// not assigned by orchestrator -> it sets assigned in setPidResources_u
-					item->status |= MSK_STATNAFF;
+		// check if CPU changed, exiting
+		if (item->mon.assigned != fthread->cpuno){
+			// change on exit???, reassign CPU?
+			int32_t CPU = item->mon.assigned;
+			(void)assignPidCPU(item, fthread->cpuno);
+
+			if (0 <= CPU){
+				item->mon.resched++;
+
+				// Removed from old CPU, should give no issues
+				if (-1 == recomputeCPUTimes(CPU))	// if -2 = CPU not found, i.e. affinity preference, no real affinity set yet, do nothing
+					if (SM_DYNSIMPLE <= prgset->sched_mode)
+						(void)pickPidReallocCPU(CPU, 0);
 			}
-
+			else
+				// not assigned by orchestrator -> it sets assigned in setPidResources_u
+				item->status |= MSK_STATNAFF;
 		}
 
 		// find next PID and put timeStamp last started running
-		if (item->pid == *frame.next_pid){
+		if (item == next){
 			item->mon.last_ts = ts;
 
 			if (item->status & MSK_STATNPRD){
@@ -963,55 +1940,48 @@ pickPidInfoS(const void * addr, const struct ftrace_thread * fthread, uint64_t t
 		if (SM_DYNSIMPLE <= prgset->sched_mode)
 			(void)pickPidReallocCPU(fthread->cpuno, 0);
 
-	// find PID switching from
-	for (node_t * item = nhead; ((item)); item=item->next )
-		// previous PID in list, exiting, update runtime data
-		if (item->pid == *frame.prev_pid){
-
-			// unassigned CPU was not part of adaptive table
-
-			if (item->status & MSK_STATNAFF){
-				if (SCHED_NODATA == item->attr.sched_policy)
-					updatePidAttr(item);
-				if (SM_PADAPTIVE <= prgset->sched_mode){
-					// never assigned to a resource and we have data (SCHED_DL), check for fit
-					if (SCHED_DEADLINE == item->attr.sched_policy) {
-						if (0 > pidReallocAndTest(checkPeriod_R(item, 0),
-								getTracer(fthread->cpuno), item))
-							warn("Unsuccessful first allocation of DL task PID %d '%s'", item->pid, (item->psig) ? item->psig : "");
-					}
-					else {
-						// Set affinity, starting from PAdaptive as it might "correct" the setting, before it doesn't
-						if ((1 < getPidAffinityAssingedNr(item)) && (!setPidAffinityAssinged(item)))
-							warn("Setting run-time affinity for unassigned PID %d '%s'", item->pid, item->psig ? item->psig : "");
-						else
-							item->status &= ~MSK_STATNAFF;	// reset - no further need for it as weight is <=1 or set not possible (process exited)
-					}
-				}
-			}
-
-			// update real-time statistics and consolidate other values on period end
-			if (item->mon.last_ts)
-				item->mon.rt += ts - item->mon.last_ts;
-
-			if (((SCHED_DEADLINE != item->attr.sched_policy)	// not deadline
-					|| (*frame.prev_state & 0x0100)				// set preemption
-					|| (0 == *frame.next_prio))					// or next is 'migration/x'; always preempts
-				&& !(*frame.prev_state & 0x00FD)) 		// Not 'D' = uninterruptible sleep -> system call, nor 'R' = running and preempted
-				break;							  		// break here, not final process switch
+	// previous PID in list, exiting, update runtime data
+	if ((prev)){
 
-			pickPidConsolidatePeriod(item, ts);
+		// unassigned CPU was not part of adaptive table
 
-			break;
+		if (prev->status & MSK_STATNAFF){
+			if (SCHED_NODATA == prev->attr.sched_policy)
+				updatePidAttr(prev);
+			if (SM_PADAPTIVE <= prgset->sched_mode){
+				// never assigned to a resource and we have data (SCHED_DL), check for fit
+				if (SCHED_DEADLINE == prev->attr.sched_policy) {
+					if (0 > pidReallocAndTest(checkPeriod_R(prev, 0),
+							getTracer(fthread->cpuno), prev))
+						warn("Unsuccessful first allocation of DL task PID %d '%s'", prev->pid, (prev->psig) ? prev->psig : "");
+				}
+				else {
+					// Set affinity, starting from PAdaptive as it might "correct" the setting, before it doesn't
+					if ((1 < getPidAffinityAssingedNr(prev)) && (!setPidAffinityAssinged(prev)))
+						warn("Setting run-time affinity for unassigned PID %d '%s'", prev->pid, prev->psig ? prev->psig : "");
+					else
+						prev->status &= ~MSK_STATNAFF;	// reset - no further need for it as weight is <=1 or set not possible (process exited)
+				}
+			}
 		}
 
-	(void)pthread_mutex_unlock(&dataMutex);
+		// update real-time statistics and consolidate other values on period end
+		if (prev->mon.last_ts)
+			prev->mon.rt += ts - prev->mon.last_ts;
+
+		if (!(((SCHED_DEADLINE != prev->attr.sched_policy)	// not deadline
+				|| (frame.prev_state & 0x0100)				// set preemption
+				|| (0 == frame.next_prio))					// or next is 'migration/x'; always preempts
+			&& !(frame.prev_state & 0x00FD))) 		// Not 'D' = uninterruptible sleep -> system call, nor 'R' = running and preempted
+			pickPidConsolidatePeriod(prev, ts);		// final process switch
+	}
 
 	return 0;
 }
 
+
 /*
- *  pickPidInfoW(): process PID fTrace wake-up / waking
+ *  pickPidInfoW_u(): process PID fTrace wake-up / waking, dataMutex must be held
  * 					update data with kernel tracer debug out
  *
  *  Arguments: - frame containing the runtime info
@@ -1021,88 +1991,416 @@ pickPidInfoS(const void * addr, const struct ftrace_thread * fthread, uint64_t t
  *  Return value: error code, 0 = success
  */
 static int
-pickPidInfoW(const void * addr, const struct ftrace_thread * fthread, uint64_t ts) {
+pickPidInfoW_u(const void * addr, const struct ftrace_thread * fthread, uint64_t ts) {
 
-	if(pickPidCommon(addr, fthread, ts)) // malformed common?
+	if(pickPidCommon_u(addr, fthread, ts)) // malformed common?
 		return -1;
 
-	// use local copy and add addr's address with its offset
-	struct tr_wakeup frame = tr_wakeup;
-	// NOTE:  we inherit const void from addr
-	for (const void ** ptr = (void*)&frame; ptr < (const void **)(&frame + 1); ptr++)
-		// add addr
-		*ptr = addr + *(int32_t*)ptr;
+	struct tr_wakeup_rec frame;
+	getWakeupRec(addr, &frame);
 
 	if (*frame.comm & 0x80) // malformed buffer? valid char?
 		return -1;
 
 	printStat("    comm=%s pid=%d prio=%d target_cpu=%03d\n",
-				frame.comm, *frame.pid, *frame.prio, *frame.target_cpu);
+				frame.comm, frame.pid, frame.prio, frame.target_cpu);
+
+	// find PID that triggered wake-up
+	node_t * item = node_idxGet(frame.pid);
+	if ((item)){
+
+		if (item->mon.last_tsP){
+
+			double period = (double)(ts - item->mon.last_tsP)/(double)NSEC_PER_SEC;
+
+			if (!(item->mon.pdf_phist)){
+				if ((runstats_histInit(&(item->mon.pdf_phist), period)))
+					warn("Histogram init failure for PID %d '%s' period", item->pid, (item->psig) ? item->psig : "");
+			}
+
+			printDbg(PFX "Period for PID %d '%s' %f\n", item->pid, (item->psig) ? item->psig : "", period);
+			if ((runstats_histAdd(item->mon.pdf_phist, period)))
+				warn("Histogram increment error for PID %d '%s' period", item->pid, (item->psig) ? item->psig : "");
+
+			if (item->mon.cdf_period){
+				item->mon.dl_diff += (int64_t)ts - (int64_t)item->mon.last_tsP - (int64_t)findPeriodMatch((uint64_t)item->mon.cdf_period);
+				if (TSCHS < item->mon.dl_diff)						// count only positive overruns based on period match
+					item->mon.dl_overrun++;							// count number of times period deviates from ideal CDF
+				item->mon.deadline = ts + item->mon.cdf_period;		// estimate deadline based on average period
+			}
+			else
+				item->mon.deadline = 0;								// Reset to avoid for deadline boundary check
+
+		}
+
+		item->mon.last_tsP = ts;		// this period start
+		item->mon.dl_count++;			// count number of periods
+	}
+
+	return 0;
+}
+
+
+/*
+ *  applyEventBatch(): apply decoded events to node data, one lock for all
+ *
+ *  Arguments: - batch of decoded events
+ *  		   - number of events in batch
+ *             - fTrace thread info
+ *
+ *  Return value: error code, 0 = success, -1 = malformed event, rest dropped
+ */
+static int
+applyEventBatch(const struct ftrace_bevent * batch, int cnt, const struct ftrace_thread * fthread){
+	int ret = 0;
 
 	// lock data to avoid inconsistency
 	(void)pthread_mutex_lock(&dataMutex);
 
-	for (node_t * item = nhead; ((item)); item=item->next )
-		// find PID that triggered wake-up
-		if (item->pid == *frame.pid){
+	for (const struct ftrace_bevent * event = batch; event < batch + cnt; event++)
+		if (0 > (ret = event->eventcall(event->addr, fthread, event->ts)))
+			break;
 
-			if (item->mon.last_tsP){
+	(void)pthread_mutex_unlock(&dataMutex);
 
-				double period = (double)(ts - item->mon.last_tsP)/(double)NSEC_PER_SEC;
+	// trace time for the PID record, readers of other CPUs may lag behind
+	if ((prgset->trace_rec) && (cnt)
+			&& batch[cnt-1].ts > atomic_load_explicit(&record_time, memory_order_relaxed))
+		atomic_store_explicit(&record_time, batch[cnt-1].ts, memory_order_relaxed);
 
-				if (!(item->mon.pdf_phist)){
-					if ((runstats_histInit(&(item->mon.pdf_phist), period)))
-						warn("Histogram init failure for PID %d '%s' period", item->pid, (item->psig) ? item->psig : "");
-				}
+	return (0 > ret) ? -1 : 0;
+}
 
-				printDbg(PFX "Period for PID %d '%s' %f\n", item->pid, (item->psig) ? item->psig : "", period);
-				if ((runstats_histAdd(item->mon.pdf_phist, period)))
-					warn("Histogram increment error for PID %d '%s' period", item->pid, (item->psig) ? item->psig : "");
+/*
+ *  parseEvents(): decode remaining events of the loaded ring-buffer page
+ *  			and apply them
+ *
+ *  Arguments: - kernel buffer structure with loaded page
+ *             - fTrace thread info (CPU)
+ *
+ *  Return value: error code, 0 = success, -1 = malformed page, rest dropped
+ */
+static int
+parseEvents(struct kbuffer * kbuf, const struct ftrace_thread * fthread){
 
-				if (item->mon.cdf_period){
-					item->mon.dl_diff += (int64_t)ts - (int64_t)item->mon.last_tsP - (int64_t)findPeriodMatch((uint64_t)item->mon.cdf_period);
-					if (TSCHS < item->mon.dl_diff)						// count only positive overruns based on period match
-						item->mon.dl_overrun++;							// count number of times period deviates from ideal CDF
-					item->mon.deadline = ts + item->mon.cdf_period;		// estimate deadline based on average period
-				}
-				else
-					item->mon.deadline = 0;								// Reset to avoid for deadline boundary check
+	struct ftrace_bevent batch[EVENT_BATCH]; // decoded events of a page
+	unsigned long long timestamp; // event time stamp, based on up-time in ns (using long long for compatibility kbuffer library)
+	int cnt = 0;
+	int ret = 0;
 
-			}
+	// read first element
+	void * pEvent = kbuffer_read_event(kbuf, &timestamp);
 
-			item->mon.last_tsP = ts;		// this period start
-			item->mon.dl_count++;			// count number of periods
+	// decode page into batch first, then apply with one lock
+	while ((pEvent) && (!ftrace_stop)) {
+		// first value is 16 bit ID, look up handler
+		uint16_t type = *(uint16_t*)pEvent;
 
+		if (type & 0xF000){	// Malformed! type ~hundreds
+			ret = -1;
 			break;
 		}
 
-	(void)pthread_mutex_unlock(&dataMutex);
+		// unknown or uninteresting events are skipped
+		if (type < elist_dispsz && (elist_disp[type])){
+			batch[cnt].eventcall = elist_disp[type];
+			batch[cnt].addr = pEvent;
+			batch[cnt].ts = timestamp;
+
+			// batch full, apply and continue with page
+			if (EVENT_BATCH == ++cnt){
+				ret = applyEventBatch(batch, cnt, fthread);
+				cnt = 0;
+				if (ret)
+					break;
+			}
+		}
+
+		// gather next element
+		pEvent = kbuffer_next_event(kbuf, &timestamp);
+	}
+
+	// apply pending, also the valid events decoded before a malformed one
+	if (cnt && (0 > applyEventBatch(batch, cnt, fthread)))
+		ret = -1;
+
+	if (0 > ret){
+		// something went wrong, dump rest of page
+		printDbg(PFX "CPU%d - Buffer probably unaligned, flushing", fthread->cpuno);
+		while (kbuffer_next_event(kbuf, NULL));
+	}
+
+	return ret;
+}
 
+/*
+ *  parsePage(): decode a ring-buffer page and apply its events
+ *
+ *  Arguments: - kernel buffer structure for page management
+ *  		   - page read from the CPU's raw trace pipe
+ *             - fTrace thread info (CPU), loss statistics are updated
+ *
+ *  Return value: error code, 0 = success, -1 = malformed page, rest dropped
+ */
+static int
+parsePage(struct kbuffer * kbuf, void * page, struct ftrace_thread * fthread){
+
+	if (kbuffer_load_subbuffer(kbuf, page))
+		warn ("Unable to parse ring-buffer page!");
+
+	int ret;
+	(void)atomic_fetch_add_explicit(&fthread->pages, 1, memory_order_relaxed);
+	if ((ret = kbuffer_missed_events(kbuf))){
+		// -1 = events lost, but the kernel did not store how many
+		(void)atomic_fetch_add_explicit(&fthread->missed, (0 < ret) ? ret : 1, memory_order_relaxed);
+		(void)atomic_fetch_add_explicit(&fthread->lossy, 1, memory_order_relaxed);
+		printDbg (PFX "Missed %d events on CPU%d!\n", ret, fthread->cpuno );
+	}
+
+	return parseEvents(kbuf, fthread);
+}
+
+/*
+ *  mapTracePipe(): memory map the ring-buffer of an opened raw trace pipe
+ *
+ *  Arguments: - file descriptor of the CPU's raw trace pipe
+ *  		   - map structure to fill
+ *
+ *  Return value: 0 on success, -1 if not supported (read pipe instead)
+ */
+static int
+mapTracePipe(int fd, struct ftrace_map * map){
+
+	map->fd = -1;
+	long pgsz = sysconf(_SC_PAGESIZE);
+
+	// meta page first, then the sub-buffers
+	map->meta = mmap(NULL, pgsz, PROT_READ, MAP_SHARED, fd, 0);
+	if (MAP_FAILED == map->meta)
+		return -1;	// not supported by the kernel, EINVAL/ENODEV
+
+	if (PIPE_BUFFER != map->meta->subbuf_size){
+		// kbuffer pages are fixed size, keep default
+		(void)munmap(map->meta, pgsz);
+		return -1;
+	}
+
+	map->datasz = (size_t)map->meta->subbuf_size * map->meta->nr_subbufs;
+	map->data = mmap(NULL, map->datasz, PROT_READ, MAP_SHARED, fd, map->meta->meta_page_size);
+	if (MAP_FAILED == map->data){
+		(void)munmap(map->meta, pgsz);
+		return -1;
+	}
+
+	map->fd = fd;
 	return 0;
 }
 
 /*
- *  thread_ftrace(): parse kernel tracer output
+ *  unmapTracePipe(): release ring-buffer memory map, does not close fd
+ *
+ *  Arguments: - map structure
+ *
+ *  Return value: -
+ */
+static void
+unmapTracePipe(struct ftrace_map * map){
+	if (0 > map->fd)
+		return;
+	(void)munmap(map->data, map->datasz);
+	(void)munmap(map->meta, sysconf(_SC_PAGESIZE));
+	map->fd = -1;
+}
+
+/*
+ *  readMappedPages(): decode all events available in the mapped ring-buffer
+ *  			without copying, swapping reader pages as needed
+ *
+ *  Arguments: - mapped ring-buffer
+ *  		   - kernel buffer structure for page management
+ *             - fTrace thread info (CPU)
+ *
+ *  Return value: 0 on success, -1 on error (reader page swap failed)
+ */
+static int
+readMappedPages(struct ftrace_map * map, struct kbuffer * kbuf, struct ftrace_thread * fthread){
+
+	int swapped = 0;
+
+	while (!ftrace_stop) {
+		void * page = map->data + (size_t)map->meta->subbuf_size * map->meta->reader.id;
+
+		if (page != kbuffer_subbuffer(kbuf)){
+			// new reader page, skip what was consumed already
+			(void)kbuffer_load_subbuffer(kbuf, page);
+			(void)atomic_fetch_add_explicit(&fthread->pages, 1, memory_order_relaxed);
+			if (map->meta->reader.read)
+				(void)kbuffer_read_at_offset(kbuf, map->meta->reader.read, NULL);
+		}
+		else
+			// the writer may still be adding to the reader page
+			(void)kbuffer_refresh(kbuf);
+
+		if ((kbuffer_read_event(kbuf, NULL))){
+			(void)parseEvents(kbuf, fthread);
+			swapped = 0;
+			continue;
+		}
+
+		if (swapped)
+			break;	// nothing new after swap, buffer is empty
+
+		// page consumed, get next reader page from kernel
+		if (0 > ioctl(map->fd, TRACE_MMAP_IOCTL_GET_READER))
+			return -1;
+		swapped = 1;
+
+		// events overwritten since the last reader page swap
+		if (map->meta->reader.lost_events){
+			(void)atomic_fetch_add_explicit(&fthread->missed, map->meta->reader.lost_events, memory_order_relaxed);
+			(void)atomic_fetch_add_explicit(&fthread->lossy, 1, memory_order_relaxed);
+			printDbg (PFX "Missed %lu events on CPU%d!\n",
+					(uint64_t)map->meta->reader.lost_events, fthread->cpuno );
+		}
+	}
+	return 0;
+}
+
+/*
+ *  replayTimedWait(): wait for a replay progress signal, replay_mutex must be held
+ *
+ *  Arguments: -
+ *
+ *  Return value: -
+ */
+static void
+replayTimedWait(){
+	struct timespec to;
+	(void)clock_gettime(CLOCK_REALTIME, &to);
+	to.tv_nsec += REPLAY_POLL;
+	tsnorm(&to);
+	(void)pthread_cond_timedwait(&replay_cond, &replay_mutex, &to);
+}
+
+/*
+ *  replayWait(): publish the trace time of the next page and wait until
+ *  			the management reached it
+ *
+ *  Arguments: - fTrace thread info, time-stamp is updated
+ *  		   - time-stamp of the page, REPLAY_DONE at end of record
+ *
+ *  Return value: 0 = continue, 1 = stop requested
+ */
+static int
+replayWait(struct ftrace_thread * fthread, uint64_t ts){
+	(void)pthread_mutex_lock(&replay_mutex);
+	fthread->ts = MAX(ts, 1);	// 0 = not started
+	(void)pthread_cond_broadcast(&replay_cond);
+	while (!ftrace_stop && REPLAY_DONE != ts
+			&& (!replay_limit || fthread->ts > replay_limit))
+		replayTimedWait();
+	(void)pthread_mutex_unlock(&replay_mutex);
+	return ftrace_stop;
+}
+
+/*
+ *  replayAdvance(): wait until all replay readers passed the trace time
+ *  			limit, then advance it by one interval
+ *
+ *  Arguments: - manage thread state, returns on stop request
+ *
+ *  Return value: 0 = next interval or stop, 1 = end of record
+ */
+static int
+replayAdvance(int32_t * pthread_state){
+	int ret = 0;
+
+	(void)pthread_mutex_lock(&replay_mutex);
+	while (0 < *pthread_state){
+		uint64_t min = REPLAY_DONE;
+		for (struct ftrace_thread * fthread = elist_thead; ((fthread)); fthread=fthread->next)
+			min = MIN(min, fthread->ts);
+
+		if (REPLAY_DONE == min){
+			ret = 1;
+			break;
+		}
+
+		// all readers are waiting past the limit, first pages set the start
+		if (min > replay_limit){
+			replay_limit = (replay_limit) ? replay_limit + (uint64_t)prgset->interval * 1000 : min;
+			(void)pthread_cond_broadcast(&replay_cond);
+			break;
+		}
+		replayTimedWait();
+	}
+	(void)pthread_mutex_unlock(&replay_mutex);
+
+	return ret;
+}
+
+/*
+ *  getTraceTime(): trace time reached, i.e., the latest event time applied
+ *  			while recording or the replay limit while replaying
+ *
+ *  Arguments: -
+ *
+ *  Return value: trace time in ns, 0 = not started
+ */
+uint64_t
+getTraceTime(){
+	if (!prgset->trace_play)
+		return atomic_load_explicit(&record_time, memory_order_relaxed);
+
+	(void)pthread_mutex_lock(&replay_mutex);
+	uint64_t ts = replay_limit;
+	(void)pthread_mutex_unlock(&replay_mutex);
+	return ts;
+}
+
+/*
+ *  openTraceRecord(): open the page record file of a CPU
  *
- *  Arguments: - pointer to fTrace thread info
+ *  Arguments: - CPU number
  *
- *  Return value: pointer to error code, 0 = success
+ *  Return value: file stream, NULL on error
  */
-void *
-thread_ftrace(void *arg){
-
-	int pstate = 0;
-	int ret = 0;
-	FILE *fp = NULL;
-	const struct ftrace_thread * fthread = (struct ftrace_thread *)arg;
-	int * retVal = malloc (sizeof(int)); // Thread return value in heap
-	*retVal = 0;
+static FILE *
+openTraceRecord(int cpuno){
+	FILE * f = openTraceFile(prgset->trace_rec, "w", TR_REC_PAGES, cpuno);
+	if (!f)
+		warn("Unable to record trace of CPU%d: %s", cpuno, strerror(errno));
+	return f;
+}
 
-	unsigned char buffer[PIPE_BUFFER];
-	void *pEvent = NULL;
-	struct kbuffer * kbuf; // kernel ring buffer structure
-	unsigned long long timestamp; // event time stamp, based on up-time in ns (using long long for compatibility kbuffer library)
+/*
+ *  recordTracePage(): append a ring-buffer page to the CPU's record
+ *
+ *  Arguments: - record file stream, closed and reset on error
+ *  		   - page, size
+ *
+ *  Return value: -
+ */
+static void
+recordTracePage(FILE ** rec, const void * page, size_t size){
+	if (!*rec)
+		return;
+	if (size != fwrite(page, 1, size, *rec)){
+		warn("Trace record write failed: %s", strerror(errno));
+		(void)fclose(*rec);
+		*rec = NULL;
+	}
+}
 
+/*
+ *  setTraceSignals(): setup signal handling for fTrace reader threads
+ *
+ *  Arguments: -
+ *
+ *  Return value: 0 on success, errno otherwise
+ */
+static int
+setTraceSignals(){
 	{ // setup interrupt handler block
 		struct sigaction act;
 
@@ -1120,8 +2418,7 @@ thread_ftrace(void *arg){
 		if (sigaction(SIGQUIT, &act, NULL) < 0)		 // quit from caller
 		{
 			perror ("Setup of sigaction failed");
-			*retVal = errno;
-			return retVal;
+			return errno;
 		}
 	} // END interrupt handler block
 
@@ -1132,10 +2429,35 @@ thread_ftrace(void *arg){
 			|| ((sigdelset(&set, SIGQUIT)))
 			|| (0 != pthread_sigmask(SIG_BLOCK, &set, NULL))){
 			perror ("Setup of sigmask failed");
-			*retVal = errno;
-			return retVal;
+			return errno;
 		}
 	}
+	return 0;
+}
+
+/*
+ *  thread_ftrace(): parse kernel tracer output
+ *
+ *  Arguments: - pointer to fTrace thread info
+ *
+ *  Return value: pointer to error code, 0 = success
+ */
+void *
+thread_ftrace(void *arg){
+
+	int pstate = 0;
+	int ret = 0;
+	FILE *fp = NULL;
+	FILE *rec = NULL;	// page record, if enabled
+	struct ftrace_thread * fthread = (struct ftrace_thread *)arg;
+	int * retVal = malloc (sizeof(int)); // Thread return value in heap
+
+	unsigned char buffer[PIPE_BUFFER];
+	struct kbuffer * kbuf; // kernel ring buffer structure
+	struct ftrace_map map; // zero-copy access, if supported
+
+	if ((*retVal = setTraceSignals()))
+		return retVal;
 
 	while(1) {
 
@@ -1145,30 +2467,42 @@ thread_ftrace(void *arg){
 			// init buffer structure for page management
 			kbuf = kbuffer_alloc(KBUFFER_LSIZE_SAME_AS_HOST, KBUFFER_ENDIAN_SAME_AS_HOST);
 
-			char* fn;
+			char fn[_POSIX_PATH_MAX];
 			if (NULL != fthread->dbgfile)
-				fn = fthread->dbgfile;
-			else{
-				fn = malloc(CMD_LEN);
-				(void)sprintf(fn, "%sper_cpu/cpu%d/trace_pipe_raw", get_debugfileprefix(), fthread->cpuno);
-			}
+				(void)snprintf(fn, sizeof(fn), "%s", fthread->dbgfile);
+			else
+				(void)snprintf(fn, sizeof(fn), "%sper_cpu/cpu%d/trace_pipe_raw", get_debugfileprefix(), fthread->cpuno);
+
 			if (-1 == access (fn, R_OK)) {
 				pstate = -1;
 				err_msg (PFX "Could not open trace pipe for CPU%d", fthread->cpuno);
 				err_msg (PIN "Tracing for CPU%d disabled", fthread->cpuno);
 				*retVal = errno;
-				free(fn);
 				break;
 			} /** if file doesn't exist **/
 
+			// record copies pages out of the pipe
+			if (prgset->trace_rec)
+				rec = openTraceRecord(fthread->cpuno);
+
+			// try zero-copy first, kernel trace pipe only
+			if (NULL == fthread->dbgfile && !(rec)){
+				int fd = open(fn, O_RDONLY | O_NONBLOCK);
+				if (0 <= fd && !mapTracePipe(fd, &map)){
+					printDbg(PFX "Reading trace output from memory mapped buffer...\n");
+					pstate = 3;
+					break;
+				}
+				if (0 <= fd)
+					close(fd);
+			}
+
 			if ((fp = fopen (fn, "r")) == NULL) {
 				pstate = -1;
 				err_msg ("File open failed");
 				*retVal = errno;
-				free(fn);
 				break;
 			} /** IF_NULL **/
-			free(fn);
 
 			printDbg(PFX "Reading trace output from pipe...\n");
 			pstate = 1;
@@ -1186,50 +2520,66 @@ thread_ftrace(void *arg){
 					*retVal = errno;
 					err_msg ("File read failed: %s", strerror(errno));
 				} // else stay here
+				else if ((prgset->trace_play) && feof(fp))
+					pstate = 2; // end of record
 
 				break;
 			}
 
-			if ((ret = kbuffer_load_subbuffer(kbuf, buffer)))
-				warn ("Unable to parse ring-buffer page!");
-
-#ifdef DEBUG
-			if ((ret = kbuffer_missed_events(kbuf)))
-				printDbg (PFX "Missed %d events on CPU%d!\n", ret, fthread->cpuno );
-#endif
+			recordTracePage(&rec, buffer, ret);
 
-			// read first element
-			pEvent = kbuffer_read_event(kbuf, &timestamp);
+			// replay, page header starts with its time-stamp
+			if ((prgset->trace_play) && replayWait(fthread, *(uint64_t *)buffer)){
+				pstate = 2;
+				break;
+			}
 
-			while ((pEvent) && (!ftrace_stop)) {
-				int (*eventcall)(const void *, const struct ftrace_thread *, uint64_t) = pickPidCommon; // default to common for unknown formats
+			(void)parsePage(kbuf, buffer, fthread);
+			break;
 
-				for (struct ftrace_elist * event = elist_head; ((event)); event=event->next)
-					// check for ID, first value is 16 bit ID
-					if (event->eventid == *(uint16_t*)pEvent){
-						eventcall = event->eventcall;
-						break;
-					}
+		case 2:
+			fclose (fp);
+			if (rec)
+				fclose (rec);
+			kbuffer_free(kbuf);
+			pstate = -1;
+			break;
 
-				ret = eventcall(pEvent, fthread, timestamp);
-				if (0 > ret){
-					// something went wrong, dump and exit
-					printDbg(PFX "CPU%d - Buffer probably unaligned, flushing", fthread->cpuno);
+		case 3:
+			if (ftrace_stop){
+				pstate = 4;
+				break;
+			}
+			{	// wait for data, SIGQUIT interrupts
+				struct pollfd pfd = { map.fd, POLLIN, 0 };
+				if (0 > poll(&pfd, 1, 1000) && EINTR != errno){
+					pstate = 4;
+					*retVal = errno;
+					err_msg ("Trace buffer poll failed: %s", strerror(errno));
 					break;
 				}
+			}
 
-				// gather next element
-				pEvent = kbuffer_next_event(kbuf, &timestamp);
+			if (readMappedPages(&map, kbuf, fthread)){
+				pstate = 4;
+				*retVal = errno;
+				err_msg ("Trace buffer reader swap failed: %s", strerror(errno));
 			}
 			break;
 
-		case 2:
-			fclose (fp);
+		case 4:
+			{
+				int fd = map.fd;
+				unmapTracePipe(&map);
+				close(fd);
+			}
 			kbuffer_free(kbuf);
 			pstate = -1;
 			break;
 
 		case -1:
+			if (prgset->trace_play)
+				(void)replayWait(fthread, REPLAY_DONE);
 			printf(PFX "Exit fTrace CPU%d thread\n", fthread->cpuno);
 			fflush(stderr);
 			return retVal;
@@ -1238,6 +2588,131 @@ thread_ftrace(void *arg){
 
 }
 
+/*
+ *  thread_ftrace_pool(): parse kernel tracer output of several CPUs,
+ *  				multiplexing the raw trace pipes with epoll
+ *
+ *  Arguments: - pointer to fTrace reader info
+ *
+ *  Return value: pointer to error code, 0 = success
+ */
+static void *
+thread_ftrace_pool(void *arg){
+
+	const struct ftrace_reader * rdr = (struct ftrace_reader *)arg;
+	int * retVal = malloc (sizeof(int)); // Thread return value in heap
+	int epfd;
+
+	unsigned char buffer[PIPE_BUFFER];
+	struct epoll_event events[rdr->cnt];
+	struct {
+		struct ftrace_thread * fthread;
+		int fd;
+		struct kbuffer * kbuf; // kernel ring buffer structure
+		struct ftrace_map map; // zero-copy access, if supported
+		FILE * rec;			// page record, if enabled
+	} slots[rdr->cnt];
+
+	if ((*retVal = setTraceSignals()))
+		return retVal;
+
+	// pin reader to its system CPU
+	if (0 <= rdr->cpuno){
+		cpu_set_t cset;
+		CPU_ZERO(&cset);
+		CPU_SET(rdr->cpuno, &cset);
+		if ((pthread_setaffinity_np(pthread_self(), sizeof(cset), &cset)))
+			warn("Unable to pin fTrace reader to CPU%d", rdr->cpuno);
+	}
+
+	if (0 > (epfd = epoll_create1(0))){
+		*retVal = errno;
+		err_msg_n(errno, "Unable to create fTrace reader epoll instance");
+		return retVal;
+	}
+
+	int cnt = 0;
+	for (int i=0; i<rdr->cnt; i++){
+		char fn[CMD_LEN];
+		struct ftrace_thread * fthread = rdr->fthreads[i];
+
+		(void)sprintf(fn, "%sper_cpu/cpu%d/trace_pipe_raw", get_debugfileprefix(), fthread->cpuno);
+		slots[cnt].fthread = fthread;
+		if (0 > (slots[cnt].fd = open(fn, O_RDONLY | O_NONBLOCK))) {
+			err_msg (PFX "Could not open trace pipe for CPU%d", fthread->cpuno);
+			err_msg (PIN "Tracing for CPU%d disabled", fthread->cpuno);
+			continue;
+		}
+
+		struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &slots[cnt] };
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, slots[cnt].fd, &ev)){
+			err_msg_n(errno, PFX "Could not poll trace pipe for CPU%d", fthread->cpuno);
+			close(slots[cnt].fd);
+			continue;
+		}
+
+		slots[cnt].kbuf = kbuffer_alloc(KBUFFER_LSIZE_SAME_AS_HOST, KBUFFER_ENDIAN_SAME_AS_HOST);
+		slots[cnt].rec = NULL;
+		if (prgset->trace_rec){
+			// record copies pages out of the pipe
+			slots[cnt].map.fd = -1;
+			slots[cnt].rec = openTraceRecord(fthread->cpuno);
+		}
+		else
+			(void)mapTracePipe(slots[cnt].fd, &slots[cnt].map); // fall-back is read
+		cnt++;
+	}
+
+	printDbg(PFX "Reading trace output of %d CPUs on CPU%d...\n", cnt, rdr->cpuno);
+
+	while ((cnt) && !ftrace_stop) {
+		int nfds = epoll_wait(epfd, events, cnt, 1000);
+		if (0 > nfds){
+			if (EINTR == errno)
+				continue; // signal, check stop
+			*retVal = errno;
+			err_msg ("Trace pipe poll failed: %s", strerror(errno));
+			break;
+		}
+
+		// one page per ready CPU and round, level triggered poll returns the rest
+		for (int i=0; i<nfds && !ftrace_stop; i++){
+			typeof(slots[0]) * slot = events[i].data.ptr;
+
+			if (0 <= slot->map.fd){
+				if (readMappedPages(&slot->map, slot->kbuf, slot->fthread)){
+					err_msg ("Trace buffer reader swap failed for CPU%d: %s", slot->fthread->cpuno, strerror(errno));
+					(void)epoll_ctl(epfd, EPOLL_CTL_DEL, slot->fd, NULL);
+				}
+				continue;
+			}
+
+			ssize_t ret = read(slot->fd, buffer, PIPE_BUFFER);
+			if (0 < ret){
+				recordTracePage(&slot->rec, buffer, ret);
+				(void)parsePage(slot->kbuf, buffer, slot->fthread);
+			}
+			else if (0 > ret && EAGAIN != errno && EINTR != errno){
+				err_msg ("Trace pipe read failed for CPU%d: %s", slot->fthread->cpuno, strerror(errno));
+				(void)epoll_ctl(epfd, EPOLL_CTL_DEL, slot->fd, NULL);
+			}
+		}
+	}
+
+	for (int i=0; i<cnt; i++){
+		unmapTracePipe(&slots[i].map);
+		close(slots[i].fd);
+		if (slots[i].rec)
+			fclose(slots[i].rec);
+		kbuffer_free(slots[i].kbuf);
+	}
+	close(epfd);
+
+	printf(PFX "Exit fTrace reader thread on CPU%d\n", rdr->cpuno);
+	fflush(stderr);
+	return retVal;
+}
+
 // #################################### THREAD specific END ############################################
 
 
@@ -1480,6 +2955,339 @@ updateStats()
 	return !(( scount % (prgset->loops*10) ));	// return 1 if we passed 10th time loops
 }
 
+// task entry of a Monte-Carlo snapshot
+struct mcbin_task {
+	stat_cdf * cdf;		// copy of the run-time CDF, NULL = none
+	double u;			// utilization if no CDF is available
+	double scale;		// 1/period in s, sampled run-time to utilization
+	int cpu;			// tracer index
+	int grp;			// container group index, -1 = none
+};
+
+// container group of a Monte-Carlo snapshot, moves as a whole
+struct mcbin_grp {
+	pid_t pid;			// representative, see pidReallocAndTest()
+	cont_t * cont;		// container of all members
+	int cpu;			// tracer index of all members, -1 = not movable
+};
+
+/*
+ * mcbinRandom(): uniform random number for CDF sampling, xorshift64*
+ *
+ * Arguments: -
+ *
+ * Return value: random value in [0,1)
+ */
+static double
+mcbinRandom(){
+	mcb.rnd ^= mcb.rnd >> 12;
+	mcb.rnd ^= mcb.rnd << 25;
+	mcb.rnd ^= mcb.rnd >> 27;
+	return (double)((mcb.rnd * 2685821657736338717ULL) >> 11) / (double)(1ULL << 53);
+}
+
+/*
+ * mcbinReset(): restart sampling for a new task set or allocation
+ *
+ * Arguments: - signature of the task set
+ * 			  - number of CPUs (tracers)
+ * 			  - number of container groups
+ *
+ * Return value: -
+ */
+static void
+mcbinReset(uint32_t sig, int ncpu, int ngrp){
+	if ((ncpu != mcb.ncpu) || (ngrp != mcb.ngrp)){
+		free(mcb.over);
+		free(mcb.cover);
+		free(mcb.trcs);
+		mcb.over = calloc(MAX(ncpu, 1), sizeof(uint32_t));
+		mcb.cover = calloc(MAX(ncpu * ngrp, 1), sizeof(uint32_t));
+		mcb.trcs = calloc(MAX(ncpu, 1), sizeof(resTracer_t *));
+		if (!mcb.over || !mcb.cover || !mcb.trcs)
+			err_exit("could not allocate memory!");
+		mcb.ncpu = ncpu;
+		mcb.ngrp = ngrp;
+	}
+	else {
+		(void)memset(mcb.over, 0, MAX(ncpu, 1) * sizeof(uint32_t));
+		(void)memset(mcb.cover, 0, MAX(ncpu * ngrp, 1) * sizeof(uint32_t));
+	}
+	mcb.sig = sig;
+	mcb.samples = 0;
+}
+
+/*
+ * mcbinFree(): free Monte-Carlo bin-packing state
+ *
+ * Arguments: -
+ *
+ * Return value: -
+ */
+static void
+mcbinFree(){
+	for (int i = 0; i < mcb.tsksz; i++)
+		if (mcb.tsk[i].cdf)
+			runstats_cdfFree(&mcb.tsk[i].cdf);
+	free(mcb.tsk);
+	free(mcb.grp);
+	free(mcb.trcs);
+	free(mcb.over);
+	free(mcb.cover);
+	mcb.tsk = NULL;
+	mcb.grp = NULL;
+	mcb.trcs = NULL;
+	mcb.over = mcb.cover = NULL;
+	mcb.ncpu = mcb.ngrp = mcb.ntsk = mcb.tsksz = mcb.samples = 0;
+}
+
+/*
+ * mcbinPeriod(): period and run-time estimate of a task for sampling
+ *
+ * Arguments: - PID item
+ * 			  - returns the run-time estimate in ns
+ *
+ * Return value: period in ns, 0 = unknown
+ */
+static uint64_t
+mcbinPeriod(const node_t * item, uint64_t * runtime){
+	if (SCHED_DEADLINE == item->attr.sched_policy){
+		*runtime = item->attr.sched_runtime;
+		return item->attr.sched_period;
+	}
+	*runtime = item->mon.cdf_runtime;
+	return findPeriodMatch(item->mon.cdf_period);
+}
+
+/*
+ * mcbinSig_u(): signature of the task set and its allocation
+ *
+ * Arguments: -
+ *
+ * Return value: FNV-1a hash over PID, CPU and period of all tasks
+ */
+static uint32_t
+mcbinSig_u(){
+	uint32_t sig = 2166136261U;
+	int ncpu = 0;
+
+	for (resTracer_t * trc = rHead; ((trc)); trc=trc->next, ncpu++)
+		for (node_t * item = trc->tasks; ((item)); item = item->mon.tnext){
+			if (0 > item->pid)
+				continue;
+
+			uint64_t runtime;
+			uint64_t period = mcbinPeriod(item, &runtime);
+			sig = (sig ^ (uint32_t)item->pid) * 16777619U;
+			sig = (sig ^ (uint32_t)ncpu) * 16777619U;
+			sig = (sig ^ (uint32_t)period) * 16777619U;
+		}
+	return sig;
+}
+
+/*
+ * mcbinSnapshot_u(): copy the allocation, tasks grouped by container, and
+ * 		their run-time CDFs for sampling without the lock. Sampling restarts
+ * 		if the signature changed.
+ *
+ * Arguments: -
+ *
+ * Return value: 0 = ready to sample, -1 = nothing to balance
+ */
+static int
+mcbinSnapshot_u(){
+	int ncpu = 0, ntsk = 0, ngrp = 0;
+
+	for (resTracer_t * trc = rHead; ((trc)); trc=trc->next, ncpu++)
+		for (node_t * item = trc->tasks; ((item)); item = item->mon.tnext)
+			ntsk++;
+	if (2 > ncpu || !ntsk)
+		return -1;
+
+	if (ntsk > mcb.tsksz){
+		if (!(mcb.tsk = realloc(mcb.tsk, ntsk * sizeof(struct mcbin_task)))
+				|| !(mcb.grp = realloc(mcb.grp, ntsk * sizeof(struct mcbin_grp))))
+			err_exit("could not allocate memory!");
+		for (int i = mcb.tsksz; i < ntsk; i++)
+			mcb.tsk[i].cdf = NULL;
+		mcb.tsksz = ntsk;
+	}
+	ncpu = ntsk = 0;
+
+	// collect the allocation, tasks in groups by container
+	for (resTracer_t * trc = rHead; ((trc)); trc=trc->next, ncpu++)
+		for (node_t * item = trc->tasks; ((item)); item = item->mon.tnext){
+			if (0 > item->pid)
+				continue;
+
+			uint64_t runtime;
+			uint64_t period = mcbinPeriod(item, &runtime);
+
+			struct mcbin_task * tk = &mcb.tsk[ntsk++];
+			tk->cpu = ncpu;
+			tk->scale = (period) ? (double)NSEC_PER_SEC / (double)period : 0.0;
+			tk->u = (period) ? (double)runtime / (double)period : 0.0;
+			tk->grp = -1;
+
+			// own copy, the node's CDF is updated or freed meanwhile
+			if ((!item->mon.pdf_cdf || runstats_cdfCopy(item->mon.pdf_cdf, &tk->cdf))
+					&& (tk->cdf))
+				runstats_cdfFree(&tk->cdf);
+
+			if (item->param && item->param->cont){
+				int g;
+				for (g = 0; g < ngrp; g++)
+					if (mcb.grp[g].cont == item->param->cont)
+						break;
+				if (g == ngrp)
+					mcb.grp[ngrp++] = (struct mcbin_grp){ item->pid, item->param->cont, ncpu };
+
+				// members on different CPUs or fixed affinity, stay
+				if ((mcb.grp[g].cpu != ncpu) || !(item->param->rscs)
+						|| (0 <= item->param->rscs->affinity))
+					mcb.grp[g].cpu = -1;
+				tk->grp = g;
+			}
+		}
+
+	uint32_t sig = mcbinSig_u();
+	if ((sig != mcb.sig) || (ncpu != mcb.ncpu) || (ngrp != mcb.ngrp))
+		mcbinReset(sig, ncpu, ngrp);
+	mcb.ntsk = ntsk;
+
+	ncpu = 0;
+	for (resTracer_t * trc = rHead; ((trc)); trc=trc->next)
+		mcb.trcs[ncpu++] = trc;
+
+	return 0;
+}
+
+/*
+ * mcbinSample(): Monte-Carlo bin-packing, sample run-times from the CDF of
+ * 		each task in the snapshot to estimate the overload probability of
+ * 		every CPU and of every container move. Sampling continues over calls
+ * 		until enough samples are collected. Runs without the lock.
+ *
+ * Arguments: - time budget for this call in ns
+ *
+ * Return value: 1 = sampling complete, 0 = not yet
+ */
+static int
+mcbinSample(uint64_t budget){
+	const int ncpu = mcb.ncpu, ngrp = mcb.ngrp;
+
+	// continue sampling until done or out of time
+	struct timespec now;
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	uint64_t end = (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec + budget;
+	double S[ncpu], G[MAX(ngrp, 1)];
+
+	while (MCBIN_SAMPLES > mcb.samples){
+		if (!(mcb.samples % MCBIN_CHKSTEP)){
+			(void)clock_gettime(CLOCK_MONOTONIC, &now);
+			if ((uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec > end)
+				return 0;
+		}
+
+		for (int c = 0; c < ncpu; c++)
+			S[c] = 0.0;
+		for (int g = 0; g < ngrp; g++)
+			G[g] = 0.0;
+
+		for (const struct mcbin_task * tk = mcb.tsk; tk < mcb.tsk + mcb.ntsk; tk++){
+			double u = (tk->cdf)
+					? tk->scale * runstats_cdfSample(tk->cdf, mcbinRandom())
+					: tk->u;
+			S[tk->cpu] += u;
+			if (0 <= tk->grp)
+				G[tk->grp] += u;
+		}
+
+		for (int c = 0; c < ncpu; c++)
+			mcb.over[c] += (MCBIN_ULMAX < S[c]);
+
+		// same sample for all moves, source and target after the move
+		for (int g = 0; g < ngrp; g++){
+			int src = mcb.grp[g].cpu;
+			if (0 > src)
+				continue;
+			int sover = (MCBIN_ULMAX < S[src] - G[g]);
+			for (int d = 0; d < ncpu; d++)
+				if (d != src)
+					mcb.cover[g * ncpu + d] += sover || (MCBIN_ULMAX < S[d] + G[g]);
+		}
+		mcb.samples++;
+	}
+
+	return 1;
+}
+
+/*
+ * mcbinMove_u(): propose the best move off the worst CPU once sampling is
+ * 		complete. A CPU is fine if P(U <= 1) >= ptresh. Nothing is proposed
+ * 		if the allocation changed since the snapshot.
+ *
+ * Arguments: - returns the node whose container should move
+ * 			  - returns the tracer to move to
+ *
+ * Return value: 1 = move proposed, 0 = no move
+ */
+static int
+mcbinMove_u(node_t ** node, resTracer_t ** ntrc){
+	const int ncpu = mcb.ncpu, ngrp = mcb.ngrp;
+
+	// samples are of an outdated allocation, restart
+	if (mcbinSig_u() != mcb.sig){
+		mcbinReset(mcb.sig, ncpu, ngrp);
+		return 0;
+	}
+
+	// find the worst CPU
+	int w = 0, best = -1;
+	for (int c = 1; c < ncpu; c++)
+		if (mcb.over[c] > mcb.over[w])
+			w = c;
+
+	uint32_t bcnt = mcb.over[w];
+	if ((double)bcnt > (1.0 - prgset->ptresh) * MCBIN_SAMPLES)
+		// move that reduces the overload most, prefer lower load on ties
+		for (int g = 0; g < ngrp; g++){
+			if (mcb.grp[g].cpu != w)
+				continue;
+			for (int d = 0; d < ncpu; d++){
+				int k = g * ncpu + d;
+				if ((d != w) && ((mcb.cover[k] < bcnt)
+						|| ((0 <= best) && (mcb.cover[k] == bcnt)
+							&& (mcb.trcs[d]->U < mcb.trcs[best % ncpu]->U)))){
+					best = k;
+					bcnt = mcb.cover[k];
+				}
+			}
+		}
+
+	// representative of the group, unchanged on the worst CPU
+	node_t * item = NULL;
+	if (0 <= best)
+		for (item = mcb.trcs[w]->tasks; ((item)); item = item->mon.tnext)
+			if (item->pid == mcb.grp[best / ncpu].pid)
+				break;
+
+	if (item){
+		printDbg(PFX "Monte-Carlo move PID %d from CPU %d to %d, overload %.3f -> %.3f\n",
+				item->pid, getTracerMainCPU(mcb.trcs[w]), getTracerMainCPU(mcb.trcs[best % ncpu]),
+				(double)mcb.over[w] / MCBIN_SAMPLES, (double)bcnt / MCBIN_SAMPLES);
+		*node = item;
+		*ntrc = mcb.trcs[best % ncpu];
+	}
+	else if ((double)mcb.over[w] > (1.0 - prgset->ptresh) * MCBIN_SAMPLES)
+		printDbg(PFX "Monte-Carlo no move for CPU %d, overload %.3f\n",
+				getTracerMainCPU(mcb.trcs[w]), (double)mcb.over[w] / MCBIN_SAMPLES);
+
+	// next round, new samples
+	mcbinReset(mcb.sig, ncpu, ngrp);
+	return (NULL != item);
+}
+
 /*
  * manageSched(): main function called to update resources
  * 					called once out of 10* loops (less often..)
@@ -1534,12 +3342,18 @@ manageSched(){
 						item->mon.resample++;
 
 						item->mon.cdf_period = newPeriod;
+						(void)updatePidTimes(item);
 						// check if there is a better fit for the period, and if it is main
 						if (-1 == updateSiblings(item))
 							warn("PID %d '%s' Sibling update not possible!", item->pid, (item->psig) ? item->psig : "");
 					}
-					else
+					else {
+						// small changes may still move the time-slot
+						int moved = (findPeriodMatch(item->mon.cdf_period) != findPeriodMatch(newPeriod));
 						item->mon.cdf_period = newPeriod;
+						if (moved)
+							(void)updatePidTimes(item);
+					}
 				}
 			}
 
@@ -1603,6 +3417,8 @@ manageSched(){
 						item->mon.resample++;
 					}
 					item->mon.cdf_runtime = newWCET;
+					if (SCHED_DEADLINE != item->attr.sched_policy)
+						(void)updatePidTimes(item);	// DL is accounted with its attributes
 					item->status &= ~MSK_STATHERR;
 				}
 				else
@@ -1625,8 +3441,23 @@ manageSched(){
 			trc->Uavg = trc->Uavg * alphaAVG + trc->U * (1.0 - alphaAVG);
 	}
 
+	// Monte-Carlo bin-packing, samples a snapshot within a time budget per call
+	int mcbin = (SM_DYNMCBIN == prgset->sched_mode) && !mcbinSnapshot_u();
+
 	(void)pthread_mutex_unlock(&dataMutex);
 
+	if (mcbin && mcbinSample((uint64_t)prgset->interval * 1000 * MCBIN_BUDGET / 100)){
+		node_t * item = NULL;
+		resTracer_t * ntrc = NULL;
+
+		// lock again, move only if the allocation is still the sampled one
+		(void)pthread_mutex_lock(&dataMutex);
+		if (mcbinMove_u(&item, &ntrc)
+				&& (-1 == pidReallocAndTest(ntrc, item->mon.trc, item)))
+			warn("PID %d '%s' Monte-Carlo reallocation not possible!", item->pid, (item->psig) ? item->psig : "");
+		(void)pthread_mutex_unlock(&dataMutex);
+	}
+
 	return 0;
 }
 
@@ -1697,6 +3528,25 @@ dumpStats (){
 		}
 	}
 
+	if (prgset->ftrace) {
+		(void)printf( "\nStatistics on fTrace ring-buffers:\n"
+						"CPU : Pages - Missed events (lossy pages) - Buffer size\n"
+						"----------------------------------------------------------------------------------\n");
+
+		for (struct ftrace_thread * fthread = elist_thead; ((fthread)); fthread=fthread->next){
+			uint64_t pages = atomic_load_explicit(&fthread->pages, memory_order_relaxed);
+			uint64_t missed = atomic_load_explicit(&fthread->missed, memory_order_relaxed);
+			uint64_t lossy = atomic_load_explicit(&fthread->lossy, memory_order_relaxed);
+
+			if (0 < fthread->bufkb)
+				(void)printf( "CPU %d: %lu - %lu(%lu) - %dkB (min %dkB)\n", fthread->cpuno,
+						pages, missed, lossy, fthread->bufkb, fthread->bufmin);
+			else
+				(void)printf( "CPU %d: %lu - %lu(%lu) - fixed\n", fthread->cpuno,
+						pages, missed, lossy);
+		}
+	}
+
 #ifdef DEBUG
 	(void)checkContParam(contparm);
 #endif
@@ -1716,6 +3566,7 @@ void *thread_manage (void *arg)
 	int32_t* pthread_state = (int32_t *)arg;
 
 	int ret;
+	int replay_end = 0;
 	struct timespec intervaltv;
 
 	// get clock, use it as a future reference for update time TIMER_ABS*
@@ -1753,6 +3604,10 @@ void *thread_manage (void *arg)
 			//no break
 
 		  case 1: // normal thread loop, check and update data
+			if (prgset->ftrace){
+				(void)updateTraceFilters();	// follow PID set changes of scanNew
+				(void)updateTraceBuffers();	// follow event losses and load
+			}
 			if (!updateStats())
 				break;	// stop here if no updates are found
 			//no break
@@ -1767,6 +3622,7 @@ void *thread_manage (void *arg)
 			*pthread_state=-2;
 			// tidy or whatever is necessary
 			dumpStats();
+			mcbinFree();
 			// no break
 
 		  case -2:
@@ -1789,6 +3645,16 @@ void *thread_manage (void *arg)
 		if (-99 == *pthread_state)
 		break;
 
+		if ((prgset->trace_play) && !replay_end){
+			// replay, next interval in trace time as soon as readers get there
+			if (!(replay_end = replayAdvance(pthread_state)))
+				continue;
+
+			(void)printf(PFX "End of trace record reached\n");
+			raise (SIGTERM); // tell main to stop
+			(void)clock_gettime(clocksources[prgset->clocksel], &intervaltv);
+		}
+
 		{
 			// absolute time relative interval shift
 
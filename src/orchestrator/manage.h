@@ -2,6 +2,8 @@
 #define __MANAGE_H_
 
 #include <sys/types.h>
+#include <stdint.h>
+#include <stdatomic.h>
 
 // Linked list of CPU threads, public to allow external calls
 struct ftrace_thread {
@@ -10,9 +12,22 @@ struct ftrace_thread {
 	int iret;			// return value of thread launch
 	int cpuno;			// CPU number monitored
 	char * dbgfile;		// file pointer to the debug file. NULL == use default
+	uint64_t ts;		// replay only, trace time of the page being read
+	// ring-buffer statistics, readers of the pool add, manage thread reads
+	_Atomic uint64_t pages;		// pages decoded
+	_Atomic uint64_t missed;	// events lost to ring-buffer overwrite, unknown count = 1
+	_Atomic uint64_t lossy;		// pages that reported lost events, not the kernel's overrun
+	// adaptive ring-buffer sizing, manage thread only
+	int bufkb;			// current buffer_size_kb, 0 = not read yet, -1 = fixed
+	int bufmin;			// initial buffer_size_kb, lower bound
+	int bufquiet;		// consecutive periods without loss and low fill
+	uint64_t bufpages;	// pages at last period
+	uint64_t bufmissed;	// missed at last period
 };
 void *thread_ftrace(void *arg);
 
+uint64_t getTraceTime();	// trace time reached, time base of the PID record
+
 void *thread_manage(void *arg); // thread that scans peridically for new entry pids
 
 #endif
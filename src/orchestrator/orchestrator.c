@@ -168,6 +168,10 @@ static void display_help(int error)
 	       "-A [NR] --adaptive[=NR]    activate Adaptive Static Schedule (ASS)\n"
 	       "                           0 = Adaptive schedule \n"
 		   "                           1 = Probabilistic adaptive schedule (default)\n"
+	       "         --admission=NAME  admission test for task placement, where NAME is\n"
+	       "                           utilization (default), demand (EDF processor\n"
+	       "                           demand test for deadline tasks), rta (response-\n"
+	       "                           time analysis for FIFO/RR tasks), or exact (both)\n"
 	       "-b       --bind            bind non-RT PIDs of container to same affinity\n"
 #ifdef DEBUG
 	       "-B       --blind           blind run (ignore environment preparation fails)\n"
@@ -184,7 +188,15 @@ static void display_help(int error)
 		   "-D                         dry run: suppress system changes/test only\n"
 		   "         --dry-run=MASK    -\"-\"-  : set hex mask for dry-run mode\n"
 	       "-f                         force execution with critical parameters\n"
-	       "-F       --ftrace          start run-time analysis using kernel fTrace\n"
+	       "-F [NR]  --ftrace[=NR]     start run-time analysis using kernel fTrace\n"
+	       "                           optional NR reader threads on system CPUs poll\n"
+	       "                           all traced CPUs, default=0 (one thread per CPU)\n"
+	       "         --trace-record=DIR\n"
+	       "                           record raw fTrace pages, event formats and\n"
+	       "                           tracked PIDs to directory DIR, implies -F\n"
+	       "         --trace-replay=DIR\n"
+	       "                           replay a trace recorded to DIR offline, as fast\n"
+	       "                           as possible, implies -F and dry run\n"
 	       "-i INTV  --interval=INTV   base interval of update thread in us default=%d\n"
 	       "-k                         keep track of ended PIDs\n"
 	       "-l LOOPS --loops=LOOPS     number of loops for container check: default=%d\n"
@@ -196,6 +208,8 @@ static void display_help(int error)
 	       "         --policy=NAME     policy of measurement thread, where NAME may be one\n"
 	       "                           of: other, normal, batch, idle, deadline, fifo or rr.\n"
 	       "-P                         with option -n, scan for children threads\n"
+	       "         --proc-events     detect new PIDs from kernel process events\n"
+	       "                           immediately, in addition to periodic scans\n"
 	       "-q       --quiet           print a summary only on exit\n"
 	       "-r RTIME --runtime=RTIME   set a maximum runtime in seconds, default=0(infinite)\n"
 	       "         --rr=RRTIME       set a SCHED_RR interval time in ms, default=100\n"
@@ -203,7 +217,7 @@ static void display_help(int error)
 	       "                           optional CMD parameter specifies ppid command\n"
 	       "-S [NR]  --system[=NR]     activate Dynamic System Schedule (DSS), alg NR \n"
 	       "                           0 = Simple period based (default)\n"
-	       "                           1 = Monte-Carlo bin (unsupported)\n"
+	       "                           1 = Monte-Carlo bin-packing\n"
 #ifdef ARCH_HAS_SMI_COUNTER
            "         --smi             Enable SMI counting\n"
 #endif
@@ -234,7 +248,8 @@ enum option_values {
 	OPT_DFLAG, OPT_DRYMASK, OPT_FTRACE, OPT_INTERVAL, OPT_LOOPS,
 	OPT_MLOCKALL, OPT_NSECS, OPT_NUMA, OPT_PRIORITY, OPT_QUIET,
 	OPT_RRTIME, OPT_RTIME, OPT_SYSTEM, OPT_SMI, OPT_VERBOSE,
-	OPT_WCET, OPT_POLICY, OPT_HELP, OPT_VERSION
+	OPT_WCET, OPT_POLICY, OPT_HELP, OPT_VERSION, OPT_TRCREC,
+	OPT_TRCPLAY, OPT_PROCEV, OPT_ADMISSION
 };
 
 /// process_options(): Process commandline options 
@@ -266,16 +281,20 @@ static void process_options (prgset_t *set, int argc, char *argv[], int max_cpus
 		static struct option long_options[] = {
 			{"affinity",         optional_argument, NULL, OPT_AFFINITY},
 			{"adaptive",         optional_argument, NULL, OPT_ADAPTIVE },
+			{"admission",        required_argument, NULL, OPT_ADMISSION },
 			{"bind",     		 no_argument,       NULL, OPT_BIND },
 			{"blind",     		 no_argument,       NULL, OPT_BLIND },
 			{"clock",            required_argument, NULL, OPT_CLOCK },
 			{"dflag",            no_argument,		NULL, OPT_DFLAG },
 			{"dry-run",          required_argument,	NULL, OPT_DRYMASK },
-			{"ftrace",           no_argument,		NULL, OPT_FTRACE },
+			{"ftrace",           optional_argument,	NULL, OPT_FTRACE },
+			{"trace-record",     required_argument,	NULL, OPT_TRCREC },
+			{"trace-replay",     required_argument,	NULL, OPT_TRCPLAY },
 			{"interval",         required_argument, NULL, OPT_INTERVAL },
 			{"loops",            required_argument, NULL, OPT_LOOPS },
 			{"mlockall",         no_argument,       NULL, OPT_MLOCKALL },
 			{"priority",         required_argument, NULL, OPT_PRIORITY },
+			{"proc-events",      no_argument,       NULL, OPT_PROCEV },
 			{"quiet",            no_argument,       NULL, OPT_QUIET },
 			{"runtime",          required_argument, NULL, OPT_RTIME },
 			{"rr",               required_argument, NULL, OPT_RRTIME },
@@ -289,7 +308,7 @@ static void process_options (prgset_t *set, int argc, char *argv[], int max_cpus
 			{"help",             no_argument,       NULL, OPT_HELP },
 			{NULL, 0, NULL, 0}
 		};
-		int c = getopt_long(argc, argv, "a::A::bBc:C:dDfFhi:kl:mn::p:Pqr:s::S::v::w:",
+		int c = getopt_long(argc, argv, "a::A::bBc:C:dDfF::hi:kl:mn::p:Pqr:s::S::v::w:",
 				    long_options, &option_index);
 		if (-1 == c)
 			break;
@@ -322,6 +341,8 @@ static void process_options (prgset_t *set, int argc, char *argv[], int max_cpus
 				optargs++;
 			}
 			break;
+		case OPT_ADMISSION:
+			set->admission = string_to_admission(optarg); break;
 		case 'b':
 		case OPT_BIND:
 			set->affother = 1; break;
@@ -364,7 +385,24 @@ static void process_options (prgset_t *set, int argc, char *argv[], int max_cpus
 			set->force = 1; break;
 		case 'F':
 		case OPT_FTRACE:
-			set->ftrace = 1; break;
+			set->ftrace = 1;
+			if (NULL != optarg) {
+				set->ftrace_rdrs = MAX(atoi(optarg), 0);
+			} else if (optind<argc && atoi(argv[optind])) {
+				set->ftrace_rdrs = MAX(atoi(argv[optind]), 0);
+				optargs++;
+			}
+			break;
+		case OPT_TRCREC:
+			free(set->trace_rec);
+			set->trace_rec = strdup(optarg);
+			set->ftrace = 1;
+			break;
+		case OPT_TRCPLAY:
+			free(set->trace_play);
+			set->trace_play = strdup(optarg);
+			set->ftrace = 1;
+			break;
 		case 'i':
 		case OPT_INTERVAL:
 			set->interval = atoi(optarg); break;
@@ -397,6 +435,8 @@ static void process_options (prgset_t *set, int argc, char *argv[], int max_cpus
 			break;
 		case 'P':
 			set->psigscan = 1; break;
+		case OPT_PROCEV:
+			set->procevents = 1; break;
 		case 'q':
 		case OPT_QUIET:
 			set->quiet = 1; break;
@@ -567,6 +607,17 @@ static void process_options (prgset_t *set, int argc, char *argv[], int max_cpus
 		set->priority = 10;
 	}
 
+	// replay runs offline, feeding recorded data only
+	if (set->trace_play) {
+		if (set->trace_rec) {
+			warn("can not record a trace while replaying: recording disabled");
+			free(set->trace_rec);
+			set->trace_rec = NULL;
+		}
+		set->ftrace = 1;
+		set->dryrun = MSK_DRYALL;
+	}
+
 	// if dryrun is set, display mask
 	if (set->dryrun)
 		display_dryrun(set->dryrun);
@@ -1365,6 +1365,12 @@ void cleanupEnvironment(prgset_t *set){
 	freeTracer(&rHead); // free
 	adaptFree();
 
+	// threads stopped, release PID nodes and their slabs
+	while (nhead)
+		node_pop(&nhead);
+	node_idxFree();
+	node_slabFree();
+
 	// unlock memory pages
 	if (set->lock_pages)
 		munlockall();
@@ -23,6 +23,7 @@
 #include "error.h"		// error and stderr print functions
 #include "cmnutil.h"	// common definitions and functions
 #include "rt-sched.h"	// scheduling attribute struct
+#include "dockerlink.h"	// Engine API container update
 
 #undef PFX
 #define PFX "[resmgnt] "
@@ -36,8 +37,10 @@
 #define SCHED_RRTONATTR	1000000 		// conversion factor from sched_rr_timeslice_ms to sched_attr, NSEC_PER_MS
 #define SCHED_PDEFAULT	NSEC_PER_SEC	// default starting period if none is specified
 #define SCHED_UHARMONIC	3				// offset for non-harmonic scores in checkUvalue (MIN)
+#define ADM_MAXIT		1000			// max iterations of admission tests, reject if exceeded
 
 static int recomputeCPUTimes_u(int32_t CPUno, node_t * skip);
+static void getPidTimes(node_t * item, struct sched_attr * attr);
 
 /*
  * --------------------- FROM HERE WE ASSUME RW LOCK ON NHEAD ------------------------
@@ -226,10 +229,9 @@ setContainerAffinity(node_t * node){
 		err_msg("No valid parameters or bit-mask allocation!");
 		return -1;
 	}
-
 	char *contp = NULL;
 	char affinity[CPUSTRLEN];
-	char affinity_old[CPUSTRLEN];
+	char affinity_old[CPUSTRLEN] = "";
 	int ret = 0;
 
 	if (parse_bitmask (node->param->cont->rscs->affinity_mask, affinity, CPUSTRLEN)){
@@ -303,12 +305,6 @@ setPidResources_u(node_t * node) {
 		node->status |= !(setContainerAffinity(node)) & MSK_STATUPD;
 		// If fixed affinity is set, set right away and as active including setAffinity
 		if (node->pid && (0 <= node->param->rscs->affinity)){
-			// at start, assign node to static/adaptive table affinity match
-			node->mon.assigned = node->param->rscs->affinity;
-
-			if (setPidAffinityAssinged(node))
-				warn("Can not assign startup allocation for PID %d", node->pid);
-
 			// put start values as dist initial values
 			if (node->param && node->param->attr){
 				if (node->param->attr->sched_period)
@@ -316,6 +312,12 @@ setPidResources_u(node_t * node) {
 				if (node->param->attr->sched_runtime)
 					node->mon.cdf_runtime = node->param->attr->sched_runtime;
 			}
+
+			// at start, assign node to static/adaptive table affinity match
+			(void)assignPidCPU(node, node->param->rscs->affinity);
+
+			if (setPidAffinityAssinged(node))
+				warn("Can not assign startup allocation for PID %d", node->pid);
 		}
 	}
 	else{
@@ -402,6 +404,56 @@ setPidResources(node_t * node) {
 	node->status |= hasSiblings;
 }
 
+/*
+ * getContainerPlacement(): CPU-set to place a created container on before its
+ *			tasks run, the CGroup does not exist yet
+ *
+ * Arguments: - pointer to container item, pid = 0 (node_t)
+ *			  - CPU-set string result, CPUSTRLEN
+ *
+ * Return value: 0 if the container is to be placed, -1 otherwise
+ */
+int
+getContainerPlacement(node_t * node, char * affinity) {
+
+	if (DM_CGRP != prgset->use_cgroup)
+		return -1;
+
+	if (findPidParameters(node, contparm) || !node->param->cont
+			|| !node->param->cont->rscs || !node->param->cont->rscs->affinity_mask)
+		return -1;
+
+	// configured mask, tasks are placed on single CPUs within at start
+	if (parse_bitmask (node->param->cont->rscs->affinity_mask, affinity, CPUSTRLEN)){
+		err_msg("Can not determine container affinity list!");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * setContainerPlacement(): place a created container through the Engine API,
+ *			synchronous call, not to be made holding the data lock
+ *
+ * Arguments: - container ID
+ *			  - CPU-set string, from getContainerPlacement()
+ *
+ * Return value: 0 on success, -1 otherwise
+ */
+int
+setContainerPlacement(const char * contid, const char * affinity) {
+
+	cont( "pre-placing %.12s's CGroups CPU's on %s", contid, affinity);
+	if (!(prgset->dryrun & MSK_DRYNOAFTY) && dlink_cpuset(contid, affinity)) {
+		if (ENOTCONN != errno)
+			warn("Can not pre-place container %.12s: %s", contid, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
 /*
  * updatePidAttr : update PID scheduling attributes and check for flags (update)
  *
@@ -432,6 +484,7 @@ updatePidAttr(node_t * node){
 		if (SCHED_NODATA != node->attr.sched_policy)
 			info("Scheduling attributes changed for pid %d", node->pid);
 		node->attr = attr_act;
+		(void)updatePidTimes(node);
 	}
 
 	// With Throttle active, doesn't work
@@ -463,6 +516,7 @@ void
 updatePidWCET(node_t * node, uint64_t wcet){
 
 	node->attr.sched_runtime = wcet;
+	(void)updatePidTimes(node);
 
 	if (sched_setattr (node->pid, &(node->attr), 0U))	// Custom function!
 		err_msg_n(errno, "Can not set new WCET");
@@ -479,36 +533,27 @@ updatePidWCET(node_t * node, uint64_t wcet){
  */
 void
 updatePidCmdline(node_t * node){
-	char * cmdline;
+	char cmdline[MAXCMD_LEN];
 	char kparam[20]; // pid{x}/cmdline read string
 
-	if ((cmdline = malloc(MAXCMD_LEN))) { // alloc memory for strings
-
-		(void)sprintf(kparam, "%d/cmdline", node->pid);
-		if (0 > getkernvar("/proc/", kparam, cmdline, MAXCMD_LEN)){
-			// try to read cmdline of pid
-			warn("can not read PID %d's command line: %s", node->pid, strerror(errno));
-			free(cmdline);
-			return;
-		}
+	(void)sprintf(kparam, "%d/cmdline", node->pid);
+	if (0 > getkernvar("/proc/", kparam, cmdline, MAXCMD_LEN)){
+		// try to read cmdline of pid
+		warn("can not read PID %d's command line: %s", node->pid, strerror(errno));
+		return;
+	}
 
-		// cut to exact (reduction = no issue)
-		cmdline=realloc(cmdline,
-			strlen(cmdline)+1);
-
-		// check for change.. NULL or different
-		if (!(node->psig) || (strcmp(cmdline, node->psig))){
-			// PIDs differ, update
-			if (node->psig)
-				free (node->psig);
-			// assign
-			node->psig = cmdline;
-		}
-		else
-			free(cmdline);
+	// check for change.. NULL or different, allocate only then
+	if (!(node->psig) || (strcmp(cmdline, node->psig))){
+		// PIDs differ, update
+		char * psig = strdup(cmdline);
+		if (!psig) // FATAL, exit and execute atExit
+			err_exit("Could not allocate memory!");
+		if (node->psig)
+			free (node->psig);
+		// assign
+		node->psig = psig;
 	}
-	else // FATAL, exit and execute atExit
-		err_exit("Could not allocate memory!");
 }
 
 /*
@@ -887,17 +932,258 @@ checkUvalue(struct resTracer * res, struct sched_attr * par, int add) {
 }
 
 /*
- *  checkPeriod(): find a resource that fits period
+ *  getAdmTask(): fill admission test parameters of a task
+ *
+ *  Arguments: - the attr structure of the task
+ *  		   - measured run-time, 0 = use the attr budget
+ *  		   - task parameters to fill
+ *
+ *  Return value: 0 if parameters are usable, -1 otherwise
+ */
+int
+getAdmTask(struct sched_attr * attr, uint64_t runtime, admTask_t * tsk) {
+	tsk->C = runtime ? runtime : attr->sched_runtime;
+	tsk->T = attr->sched_period ? attr->sched_period : attr->sched_deadline;
+	tsk->D = attr->sched_deadline ? attr->sched_deadline : tsk->T;
+	tsk->policy = attr->sched_policy;
+	tsk->prio = attr->sched_priority;
+
+	return (tsk->C && tsk->T) ? 0 : -1;
+}
+
+/*
+ *  getTracerTasks(): fill admission test parameters of the tasks
+ *  				  accounted on a resource, run-time values
+ *
+ *  Arguments: - resource entry for this CPU
+ *  		   - task parameter array to fill, NULL = count only
+ *  		   - node to skip, NULL for none
+ *
+ *  Return value: number of tasks filled, or an upper bound if counting
+ */
+static int
+getTracerTasks(struct resTracer * res, admTask_t * tsk, void * skip) {
+	int n = 0;
+
+	for (node_t * item = res->tasks; ((item)); item = item->mon.tnext) {
+		if (0 > item->pid || item == (node_t *)skip)
+			continue;
+
+		if (!tsk) {
+			n++;
+			continue;
+		}
+
+		// measured times, for deadline tasks run-time only
+		struct sched_attr attr;
+		getPidTimes(item, &attr);
+		if (!getAdmTask(&attr, (SCHED_DEADLINE == attr.sched_policy)
+				? item->mon.cdf_runtime : 0, &tsk[n]))
+			n++;
+	}
+	return n;
+}
+
+/*
+ *  demandBound(): processor demand of a task set in the interval [0,t]
+ *
+ *  Arguments: - task parameter array
+ *  		   - number of tasks
+ *  		   - interval length t
+ *
+ *  Return value: the demand h(t), in ns
+ */
+static uint64_t
+demandBound(admTask_t * tsk, int n, uint64_t t) {
+	uint64_t h = 0;
+
+	for (int i = 0; i < n; i++)
+		if (tsk[i].D <= t)
+			h += ((t - tsk[i].D) / tsk[i].T + 1) * tsk[i].C;
+	return h;
+}
+
+/*
+ *  lastDeadline(): find the latest absolute deadline before t
+ *
+ *  Arguments: - task parameter array
+ *  		   - number of tasks
+ *  		   - interval length t
+ *
+ *  Return value: the deadline, 0 if there is none
+ */
+static uint64_t
+lastDeadline(admTask_t * tsk, int n, uint64_t t) {
+	uint64_t d = 0;
+
+	for (int i = 0; i < n; i++)
+		if (tsk[i].D < t)
+			d = MAX(d, tsk[i].D + (t - tsk[i].D - 1) / tsk[i].T * tsk[i].T);
+	return d;
+}
+
+/*
+ *  checkDemand(): EDF processor-demand test (QPA) of the deadline tasks
+ *  			   in a task set
+ *
+ *  Arguments: - task parameter array, other policies are ignored
+ *  		   - number of tasks
+ *
+ *  Return value: 0 if schedulable, -1 = not schedulable or undecided
+ */
+static int
+checkDemand(admTask_t * tasks, int cnt) {
+	admTask_t tsk[cnt];
+	int n = 0;
+
+	// deadline tasks preempt all others, the rest does not count
+	for (int i = 0; i < cnt; i++)
+		if (SCHED_DEADLINE == tasks[i].policy)
+			tsk[n++] = tasks[i];
+
+	double U = 0.0, La = 0.0;
+	uint64_t dmin = UINT64_MAX, dmax = 0, L = 0, w;
+	int it = 0;
+
+	for (int i = 0; i < n; i++) {
+		U += (double)tsk[i].C / (double)tsk[i].T;
+		if (tsk[i].T > tsk[i].D)
+			La += (double)(tsk[i].T - tsk[i].D) * (double)tsk[i].C / (double)tsk[i].T;
+		dmin = MIN(dmin, tsk[i].D);
+		dmax = MAX(dmax, tsk[i].D);
+		L += tsk[i].C;
+	}
+
+	if (!n)
+		return 0;
+	if (MAX_UL < U)
+		return -1;
+
+	// synchronous busy period, upper bound for the interval to check
+	do {
+		w = L;
+		L = 0;
+		for (int i = 0; i < n; i++)
+			L += (w + tsk[i].T - 1) / tsk[i].T * tsk[i].C;
+		if (ADM_MAXIT < ++it)
+			return -1;
+	} while (L != w);
+
+	// La bound, only if load leaves slack
+	if (1.0 > U) {
+		La = MAX((double)dmax, La / (1.0 - U));
+		if (La < (double)L)
+			L = (uint64_t)La;
+	}
+
+	// quick processor-demand analysis, walk t backwards from L
+	uint64_t t = lastDeadline(tsk, n, L), h = 0;
+	while ((t) && ((h = demandBound(tsk, n, t)) <= t) && (h > dmin)) {
+		t = (h < t) ? h : lastDeadline(tsk, n, t);
+		if (ADM_MAXIT < ++it)
+			return -1;
+	}
+
+	return (!t || h <= dmin) ? 0 : -1;
+}
+
+/*
+ *  checkResponse(): fixed-priority response-time analysis of the FIFO and
+ *  				 RR tasks in a task set
+ *
+ *  	Deadline tasks interfere with all of them, with a release jitter of
+ *  	D-C as the budget may be consumed anywhere in the deadline window.
+ *  	Equal priorities are counted as interference, a safe bound for both
+ *  	FIFO order and RR slices.
+ *
+ *  Arguments: - task parameter array, other policies are ignored
+ *  		   - number of tasks
+ *
+ *  Return value: 0 if schedulable, -1 = not schedulable or undecided
+ */
+static int
+checkResponse(admTask_t * tsk, int n) {
+
+	for (int i = 0; i < n; i++) {
+		if ((SCHED_FIFO != tsk[i].policy) && (SCHED_RR != tsk[i].policy))
+			continue;
+
+		uint64_t R = tsk[i].C, w;
+		int it = 0;
+
+		// iterate R = C_i + sum_hp ceil((R + J_j)/T_j) C_j up to the fixed point
+		do {
+			w = R;
+			R = tsk[i].C;
+			for (int j = 0; j < n; j++) {
+				uint64_t J = 0;
+				if (j == i)
+					continue;
+				if (SCHED_DEADLINE == tsk[j].policy)
+					J = (tsk[j].D > tsk[j].C) ? tsk[j].D - tsk[j].C : 0;
+				else if (((SCHED_FIFO != tsk[j].policy) && (SCHED_RR != tsk[j].policy))
+						|| (tsk[j].prio < tsk[i].prio))
+					continue;
+				R += (w + J + tsk[j].T - 1) / tsk[j].T * tsk[j].C;
+			}
+			if ((tsk[i].D < R) || (ADM_MAXIT < ++it))
+				return -1;
+		} while (R != w);
+	}
+	return 0;
+}
+
+/*
+ *  checkAdmission(): run the enabled admission tests on the tasks of a
+ *  				  resource with a candidate task added
+ *
+ *  Arguments: - resource entry for this CPU
+ *  		   - the attr structure of the candidate task
+ *  		   - function filling the tasks accounted on the resource
+ *  		   - argument for the fill function, e.g. item to skip
+ *
+ *  Return value: 0 if admitted, -1 = rejected
+ */
+static int
+checkAdmission(struct resTracer * res, struct sched_attr * attr,
+		admTasks_t tasks, void * arg) {
+	int demand = (prgset->admission & ADM_DEMAND)
+				&& (SCHED_DEADLINE == attr->sched_policy);
+	int rta = (prgset->admission & ADM_RTA)
+				&& ((SCHED_DEADLINE == attr->sched_policy)
+				|| (SCHED_FIFO == attr->sched_policy)
+				|| (SCHED_RR == attr->sched_policy));
+
+	if (!demand && !rta)
+		return 0;
+
+	admTask_t tsk[tasks(res, NULL, arg) + 1];
+	int n = tasks(res, tsk, arg);
+
+	if (!getAdmTask(attr, 0, &tsk[n]))
+		n++;
+
+	if (demand && checkDemand(tsk, n))
+		return -1;
+
+	return (rta && checkResponse(tsk, n)) ? -1 : 0;
+}
+
+/*
+ *  checkPeriod_u(): find a resource that fits period
  *
  *  Arguments: - the attr structure of the task
  *  		   - the set affinity, positive = fixed, negative = preference
  *  		   - the running CPU, -1 if not set yet
+ *  		   - function filling the tasks accounted on a resource
+ *  		   - argument for the fill function, e.g. item to skip
  *
  *  Return value: a pointer to the resource tracer
  * 					returns null if nothing is found
  */
-resTracer_t *
-checkPeriod(struct sched_attr * attr, int affinity, int CPU) {
+static resTracer_t *
+checkPeriod_u(struct sched_attr * attr, int affinity, int CPU,
+		admTasks_t tasks, void * arg) {
 	resTracer_t * ftrc = NULL;
 	int last = INT_MAX;	// last checked tracer's score, max value by default
 	float Ulast = 10.0;	// last checked traces's utilization rate
@@ -911,6 +1197,11 @@ checkPeriod(struct sched_attr * attr, int affinity, int CPU) {
 	for (resTracer_t * trc = rHead; ((trc)); trc=trc->next){
 
 		res = checkUvalue(trc, attr, 0);
+
+		// exact tests on top of the utilization bound, if enabled
+		if ((0 <= res) && (checkAdmission(trc, attr, tasks, arg)))
+			res = -1;
+
 		if ((0 <= res && res < last)	// better match
 			|| ((res == last) &&		// equal match but!
 
@@ -933,6 +1224,38 @@ checkPeriod(struct sched_attr * attr, int affinity, int CPU) {
 	return ftrc;
 }
 
+/*
+ *  checkPeriod(): find a resource that fits period
+ *
+ *  Arguments: - the attr structure of the task
+ *  		   - the set affinity, positive = fixed, negative = preference
+ *  		   - the running CPU, -1 if not set yet
+ *
+ *  Return value: a pointer to the resource tracer
+ * 					returns null if nothing is found
+ */
+resTracer_t *
+checkPeriod(struct sched_attr * attr, int affinity, int CPU) {
+	return checkPeriod_u(attr, affinity, CPU, getTracerTasks, NULL);
+}
+
+/*
+ *  checkPeriod_A(): find a resource that fits period
+ *  				 admission tests use the given task accounting
+ *
+ *  Arguments: - the attr structure of the task
+ *  		   - the set affinity, positive = fixed, negative = preference
+ *  		   - function filling the tasks accounted on a resource
+ *  		   - argument for the fill function, e.g. item to skip
+ *
+ *  Return value: a pointer to the resource tracer
+ * 					returns null if nothing is found
+ */
+resTracer_t *
+checkPeriod_A(struct sched_attr * attr, int affinity, admTasks_t tasks, void * arg) {
+	return checkPeriod_u(attr, affinity, -1, tasks, arg);
+}
+
 /*
  *  checkPeriod_R(): find a resource that fits period
  *  				 uses run-time values for non-DEADLINE scheduled tasks
@@ -960,15 +1283,10 @@ checkPeriod_R(node_t * item, int include) {
 	if ((item->param) && (item->param->rscs))
 		affinity = item->param->rscs->affinity;
 
-	if (SCHED_DEADLINE == item->attr.sched_policy)
-		ftrc = checkPeriod(&item->attr, affinity, item->mon.assigned);
-	else{
-		struct sched_attr attr = { SCHED_ATTR_SIZE };
-		attr.sched_policy = item->attr.sched_policy;
-		attr.sched_runtime = item->mon.cdf_runtime;
-		attr.sched_period = findPeriodMatch(item->mon.cdf_period);
-		ftrc = checkPeriod(&attr, affinity, item->mon.assigned);
-	}
+	struct sched_attr attr;
+	getPidTimes(item, &attr);
+	ftrc = checkPeriod_u(&attr, affinity, item->mon.assigned, getTracerTasks,
+			(include) ? NULL : item);
 
 	// reset to with item
 	if (!(include))
@@ -1045,42 +1363,66 @@ getTracerMainCPU(resTracer_t * res) {
 	return -1;
 }
 
+/*
+ *  getPidTimes(): scheduling parameters a task is accounted with,
+ *  			   run-time values for non-DEADLINE scheduled tasks
+ *
+ *  Arguments:  - PID node
+ *  			- attribute structure to fill
+ *
+ *  Return value: -
+ */
+static void
+getPidTimes(node_t * item, struct sched_attr * attr) {
+
+	if (SCHED_DEADLINE == item->attr.sched_policy){
+		*attr = item->attr;
+		return;
+	}
+
+	*attr = (struct sched_attr){ SCHED_ATTR_SIZE };
+	attr->sched_policy = item->attr.sched_policy;
+	attr->sched_priority = item->attr.sched_priority;
+	attr->sched_runtime = item->mon.cdf_runtime;
+	attr->sched_period = findPeriodMatch(item->mon.cdf_period);
+}
+
 /*
  *  recomputeTimes_u(): recomputes base and utilization factor of a resource
+ *  					from its task list, only if outdated or with skip
  *
  *  Arguments:  - resource entry for this CPU
- *  			- node to skip for computation
+ *  			- node to skip for computation, leaves the values outdated
  *
  *  Return value: Negative values return error; -1 = error / over-utilizzation
  */
 static int
 recomputeTimes_u(struct resTracer * res, node_t * skip) {
 
-	struct resTracer * resNew = calloc (1, sizeof(struct resTracer));
+	// accounting is up to date
+	if (!skip && !(res->status & MSK_STATTUPD))
+		return (MAX_UL < res->U) ? -1 : 0;
+
+	struct resTracer resNew = { 0 };
 	int rv = 0;
 
-	// find PID switching from
-	for (node_t * item = nhead; ((item)); item=item->next){
-		if (!numa_bitmask_isbitset(res->affinity, item->mon.assigned)
-				|| 0 > item->pid || item == skip)
+	for (node_t * item = res->tasks; ((item)); item = item->mon.tnext) {
+		if (0 > item->pid || item == skip)
 			continue;
 
-		if (SCHED_DEADLINE == item->attr.sched_policy)
-			rv = MIN(checkUvalue(resNew, &item->attr, 1), rv);
-		else{
-			struct sched_attr attr = { SCHED_ATTR_SIZE };
-			attr.sched_policy = item->attr.sched_policy;
-			attr.sched_runtime = item->mon.cdf_runtime;
-			attr.sched_period = findPeriodMatch(item->mon.cdf_period);
-			rv = MIN(checkUvalue(resNew, &attr, 1), rv);
-		}
+		struct sched_attr attr;
+		getPidTimes(item, &attr);
+		rv = MIN(checkUvalue(&resNew, &attr, 1), rv);
 	}
 
-	res->basePeriod = resNew->basePeriod;
-	res->usedPeriod = resNew->usedPeriod;
-	res->U = resNew->U;
+	res->basePeriod = resNew.basePeriod;
+	res->usedPeriod = resNew.usedPeriod;
+	res->U = resNew.U;
+	if (skip)
+		res->status |= MSK_STATTUPD;
+	else
+		res->status &= ~MSK_STATTUPD;
 
-	free(resNew);
 	return rv;
 }
 
@@ -1094,6 +1436,7 @@ recomputeTimes_u(struct resTracer * res, node_t * skip) {
 int
 recomputeTimes(struct resTracer * res) {
 
+	res->status |= MSK_STATTUPD;	// force, task parameters may have changed
 	return recomputeTimes_u(res, NULL);
 }
 
@@ -1134,6 +1477,80 @@ recomputeCPUTimes(int32_t CPUno) {
 	return recomputeCPUTimes_u(CPUno, NULL);
 }
 
+/*
+ *  assignPidCPU(): assign a PID to a CPU and move its times to the
+ *  				resource tracer of that CPU
+ *
+ *  Arguments:  - PID node
+ *  			- CPU number, -1 = unassigned
+ *
+ *  Return value: Negative values return error
+ *  		-1 = error / over-utilizzation of the new tracer
+ *  		-2 = tracer/CPU number not found
+ */
+int
+assignPidCPU(node_t * item, int32_t CPUno) {
+	resTracer_t * trc = (0 <= CPUno) ? getTracer(CPUno) : NULL;
+
+	item->mon.assigned = CPUno;
+	if (item->mon.trc == trc)
+		return (trc) ? recomputeTimes_u(trc, NULL) : -2;
+
+	releasePidCPU(item);
+	if (!trc)
+		return -2;
+
+	node_trcAdd(trc, item);
+	if ((trc->status & MSK_STATTUPD) || 0 > item->pid)
+		return recomputeTimes_u(trc, NULL);
+
+	// add on top, same as appending in recomputeTimes_u
+	struct sched_attr attr;
+	int status = trc->status;
+	getPidTimes(item, &attr);
+	(void)checkUvalue(trc, &attr, 1);
+	trc->status = status;	// keep harmonic flag, as on recompute
+
+	return (MAX_UL < trc->U) ? -1 : 0;
+}
+
+/*
+ *  releasePidCPU(): remove the times of a PID from its resource tracer,
+ *  				 the assigned CPU number is kept
+ *
+ *  Arguments:  - PID node
+ *
+ *  Return value: -
+ */
+void
+releasePidCPU(node_t * item) {
+	resTracer_t * trc = item->mon.trc;
+
+	if (!trc)
+		return;
+
+	node_trcDel(item);
+	(void)recomputeTimes_u(trc, NULL);
+}
+
+/*
+ *  updatePidTimes(): update resource tracer after a change of runtime
+ *  				  or period of a PID
+ *
+ *  Arguments:  - PID node
+ *
+ *  Return value: Negative values return error
+ *  		-1 = error / over-utilizzation
+ *  		-2 = not assigned to a tracer
+ */
+int
+updatePidTimes(node_t * item) {
+	if (!item->mon.trc)
+		return -2;
+
+	return recomputeTimes(item->mon.trc);
+}
+
 /* ------------------- Node configuration management from here ---------------------------- */
 
 /*
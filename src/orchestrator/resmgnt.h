@@ -29,10 +29,24 @@
 
 	// WARN! node is assumed to be already locked!
 	void setPidResources(node_t * node);	// set resources of PID in memory (new or update)
+	int getContainerPlacement(node_t * node, char * affinity);	// created container CPU-set, locked
+	int setContainerPlacement(const char * contid, const char * affinity); // pre-place, unlocked
 	void updatePidAttr(node_t * node);		// update PID scheduling attributes and set flags if needed
 	void updatePidWCET(node_t * node, uint64_t wcet); // update WCET value to computed result
 	void updatePidCmdline(node_t * node);	// update PID command line
 
+	// task parameters for admission tests
+	typedef struct adm_task {
+		uint64_t C;			// run-time, measured if available
+		uint64_t D;			// relative deadline
+		uint64_t T;			// period
+		uint32_t policy;	// scheduling policy
+		uint32_t prio;		// static priority, FIFO and RR
+	} admTask_t;
+
+	// fill tasks accounted on a resource, tsk = NULL counts only
+	typedef int (*admTasks_t)(struct resTracer * res, admTask_t * tsk, void * arg);
+
 	// resTracer functions for simple and adaptive schedule
 	void createResTracer(); 					// create linked list elements for all CPU's
 	int checkUvalue(struct resTracer * res,
@@ -41,11 +55,18 @@
 			* attr, int affinity, int CPU);		// find a resTracer that fits best
 	resTracer_t * checkPeriod_R(node_t * item, int include);
 												// same, but with node for runtime
+	resTracer_t * checkPeriod_A(struct sched_attr * attr, int affinity,
+			admTasks_t tasks, void * arg);		// same, but with custom task accounting
+	int getAdmTask(struct sched_attr * attr,
+			uint64_t runtime, admTask_t * tsk);	// fill admission test parameters of a task
 	resTracer_t * getTracer(int32_t CPUno);		// return resTracer for CPU no
 	resTracer_t * grepTracer();					// return resTreacer with lowest Ul
 	int	getTracerMainCPU(resTracer_t * res);	// Return ID of main CPU of resTracer affinity
 	int	recomputeCPUTimes(int32_t CPUno);		// recompute UL for CPU
 	int recomputeTimes(struct resTracer * res);	// recompute UL for CPU using Trace
+	int assignPidCPU(node_t * item, int32_t CPUno);	// assign PID to CPU, move times to its tracer
+	void releasePidCPU(node_t * item);			// remove PID times from its tracer
+	int updatePidTimes(node_t * item);			// runtime or period of PID changed, update tracer
 	int	setPidAffinityAssinged (node_t * node);	// update PID affinity in run-time
 	int	getPidAffinityAssingedNr(node_t * node);// get the number of CPUs that have an affinity with the PID
 
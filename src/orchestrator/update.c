@@ -14,6 +14,16 @@
 #include <dirent.h>			// dir entry structure and expl
 #include <errno.h>			// error numbers and strings
 #include <time.h>			// constants and functions for clock
+#include <sys/stat.h>		// directory creation, trace record
+#include <poll.h>			// wait for process events
+#include <sys/socket.h>		// netlink socket, process events
+#include <linux/netlink.h>	// netlink message format
+#include <linux/connector.h>	// kernel connector, process events
+#include <linux/cn_proc.h>	// process event types
+#include <sys/inotify.h>	// container CGroup change notification
+#include <sys/syscall.h>	// pidfd_open
+#include <sys/resource.h>	// fd limit, pidfd cap
+#include <stdarg.h>			// variable argument lists, PID record
 
 // Custom includes
 #include "orchestrator.h"
@@ -23,6 +33,7 @@
 #include "error.h"		// error and stderr print functions
 #include "cmnutil.h"	// common definitions and functions
 #include "resmgnt.h"	// resource management for PIDs and Containers
+#include "manage.h"		// trace time, time base of the PID record
 
 // locally globals variables used here ->
 static long ticksps = 1; // get clock ticks per second (Hz)-> for stat readout
@@ -30,8 +41,73 @@ static long ticksps = 1; // get clock ticks per second (Hz)-> for stat readout
 #undef PFX
 #define PFX "[update] "
 
-// GLocal vars
-char * pidSignature;
+// Trace record, tracked PIDs, see --trace-record/--trace-replay
+#define TR_REC_PIDS	"pids"	// trace time, then '+' PID, container ID, image ID and signature, or '-' PID
+#define TR_REC_BUFSZ	4096	// initial size of the record buffer
+static FILE * pidrec;		// record of tracked PIDs, NULL = off
+static char * pidrecbuf;	// records of an update, written once unlocked
+static size_t pidreclen;	// used record buffer
+static size_t pidrecsz;		// allocated record buffer
+static FILE * pidplay;		// record being replayed, NULL = not open
+static char pidplayln[BUFRD];	// next record, read ahead
+static int pidplaypend;		// read ahead record not applied yet
+static node_t * pidplaylst;	// recorded PIDs alive at the replay time
+
+// Kernel proc connector, PIDs detected on fork/exec/exit, see --proc-events
+#define PROCEV_BUFSZ	8192	// receive buffer, several events per read
+static int procfd = -1;			// netlink socket, -1 = off
+static struct {
+	uint64_t cnt;				// PIDs added on events
+	uint64_t sum;				// total latency event to configured PID, ns
+	uint64_t max;				// max latency, ns
+} proclat;
+
+// PID lifetime tracking, exit of managed PIDs through pidfds
+#ifndef PIDFD_THREAD
+	#define PIDFD_THREAD	O_EXCL	// pidfd of a thread, kernel >= 6.9
+#endif
+#define PIDFD_SCANS		10		// scanNew() every PIDFD_SCANS loops with events
+#define PIDFD_FDSHARE	4		// pidfds use at most 1/n of the fd limit
+#define PIDFD_MAXFDS	4096	// pidfds upper bound, unlimited fds
+static int pidfdon;				// pidfds enabled, update thread only
+static int pidfdmax = PIDFD_MAXFDS; // watched PIDs cap, others scanned
+static int pidfdmiss;			// managed PIDs without pidfd
+static struct pollfd * evpoll;	// [0] = process events, [1..pidfdcnt] = pidfds
+static pid_t * evpollpid;		// PID of each pidfd, same index
+static int pidfdcnt;			// number of pidfds
+static int pidfdsz;				// allocated pidfd entries
+
+// Container CGroup cache, see getContPids()
+#define CGRP_EVTS		"cgroup.events"	// CGv2 populated/frozen state, notifies on change
+#define CGRP_EVBUFSZ	4096	// inotify read buffer
+struct cont_cgrp {
+	struct cont_cgrp * next;
+	char * dname;		// CGroup directory name
+	char * contid;		// container ID
+	int wd;				// watch on the events file, -1 = none
+	int dirty;			// changed, read again
+	int seen;			// present in directory, sync only
+	node_t * pids;		// PIDs at last read
+};
+static struct cont_cgrp * cgrphead;	// cached container CGroups
+static int cgrpfd = -1;	// inotify instance, -1 = unavailable
+static int cgrpwd = -1;	// watch on Docker CGroup directory, -1 = none
+static int cgrpinit;	// watches set up
+static int cgrpsync;	// directory to be read again
+
+// Scan string table, strings of PIDs found by a scan are borrowed from here
+// and copied only if the PID is new, see scanNew()
+#define SCAN_STRMIN		256		// minimum number of buckets
+struct scan_str {
+	struct scan_str * next;
+	uint32_t hash;		// FNV-1a of str
+	uint32_t gen;		// last scan using it
+	char str[];
+};
+static struct scan_str ** scanstr;	// buckets, power of 2
+static size_t scanstrsz;	// number of buckets
+static size_t scanstrcnt;	// number of strings
+static uint32_t scangen;	// scan count
 
 // declarations 
 static void scanNew();
@@ -51,179 +127,666 @@ cmpPidItem (const void * a, const void * b) {
 }
 
 /*
- *  getContPids(): utility function to get PID list of interest from CGroups
+ *  internScanStr(): get the shared copy of a string found by a scan
  *
- *  Arguments: - pointer to linked list storing newly found PIDs
+ *  Arguments: - string to look for
+ *
+ *  Return value: interned string, valid until a scan does not use it
+ */
+static char *
+internScanStr (const char * str)
+{
+	uint32_t hash = 2166136261U;
+	for (const char * c = str; *c; c++)
+		hash = (hash ^ (unsigned char)*c) * 16777619U;
+
+	// keep load factor below 1, rehash on growth
+	if (scanstrcnt >= scanstrsz) {
+		size_t sz = (scanstrsz) ? scanstrsz * 2 : SCAN_STRMIN;
+		struct scan_str ** tbl = calloc(sz, sizeof(struct scan_str *));
+		if (!tbl)
+			err_exit("Could not allocate memory!");
+		for (size_t i = 0; i < scanstrsz; i++)
+			while (scanstr[i]) {
+				struct scan_str * ent = scanstr[i];
+				scanstr[i] = ent->next;
+				ent->next = tbl[ent->hash & (sz-1)];
+				tbl[ent->hash & (sz-1)] = ent;
+			}
+		free(scanstr);
+		scanstr = tbl;
+		scanstrsz = sz;
+	}
+
+	struct scan_str ** slot = &scanstr[hash & (scanstrsz-1)];
+	for (struct scan_str * ent = *slot; ((ent)); ent = ent->next)
+		if (ent->hash == hash && !strcmp(ent->str, str)) {
+			ent->gen = scangen;
+			return ent->str;
+		}
+
+	size_t len = strlen(str) + 1;
+	struct scan_str * ent = malloc(sizeof(struct scan_str) + len);
+	if (!ent)
+		err_exit("Could not allocate memory!");
+	ent->hash = hash;
+	ent->gen = scangen;
+	(void)memcpy(ent->str, str, len);
+	ent->next = *slot;
+	*slot = ent;
+	scanstrcnt++;
+	return ent->str;
+}
+
+/*
+ *  sweepScanStrs(): drop strings the last scan did not use, no borrowed
+ *  			string may be left
+ *
+ *  Arguments: 
  *
  *  Return value: --
  */
 static void
-getContPids (node_t **pidlst)
+sweepScanStrs ()
 {
-	struct dirent *dir;
-	DIR *d = opendir(prgset->cpusetdfileprefix);
-	if (d) {
-		char *fname = NULL;
-		char buf[BUFRD];	// read buffer
-		char *pid, *pid_ptr;	// strtok_r variables
-
-		printDbg(PFX "Container detection!\n");
-
-		while ((dir = readdir(d)) != NULL) {
-			// scan trough docker CGroups, find them?
-			if ((strlen(dir->d_name)>60)) {// container strings are very long! - KISS as it has to be efficient
-				if ((fname=realloc(fname,strlen(prgset->cpusetdfileprefix)+strlen(dir->d_name)+strlen("/" CGRP_PIDS)+1))) {
-					// copy to new prefix
-					fname = strcat(strcpy(fname,prgset->cpusetdfileprefix),dir->d_name);
-					fname = strcat(fname,"/" CGRP_PIDS);
-
-					// prepare literal and open pipe request
-					int fd = open(fname, O_RDONLY);
-
-					int nleft = 0;	// number of bytes left to parse
-					int	ret;		// return value number of bytes read, or error code
-					int count = 0;  // number of PIDS
-
-					// Scan through string and put in array
-					while((ret = read(fd, buf+nleft,BUFRD-nleft-1))) {
-
-						if (0 > ret){ // error..
-							if (EINTR == errno) // retry on interrupt
-								continue;
-							warn("kernel tasks read error!");
-							break;
-						}
+	for (size_t i = 0; i < scanstrsz; i++)
+		for (struct scan_str ** ent = &scanstr[i]; ((*ent)); )
+			if ((*ent)->gen != scangen) {
+				struct scan_str * del = *ent;
+				*ent = del->next;
+				free(del);
+				scanstrcnt--;
+			}
+			else
+				ent = &(*ent)->next;
+	scangen++;
+}
+
+/*
+ *  freeScanStrs(): free the scan string table
+ *
+ *  Arguments: 
+ *
+ *  Return value: --
+ */
+static void
+freeScanStrs ()
+{
+	scangen++;
+	sweepScanStrs();
+	free(scanstr);
+	scanstr = NULL;
+	scanstrsz = 0;
+}
+
+/*
+ *  ownScanPid(): copy the borrowed strings of a PID found by a scan, before
+ *  			it enters the PID list
+ *
+ *  Arguments: - PID node
+ *
+ *  Return value: --
+ */
+static void
+ownScanPid (node_t * node)
+{
+	if ((node->psig && !(node->psig = strdup(node->psig)))
+			|| (node->contid && !(node->contid = strdup(node->contid)))
+			|| (node->imgid && !(node->imgid = strdup(node->imgid))))
+		err_exit("Could not allocate memory!");
+}
+
+/*
+ *  popScanPid(): drop a PID found by a scan, leaving its borrowed strings
+ *
+ *  Arguments: - pointer to the PID node reference
+ *
+ *  Return value: --
+ */
+static void
+popScanPid (node_t ** node)
+{
+	(*node)->psig = NULL;
+	(*node)->contid = NULL;
+	(*node)->imgid = NULL;
+	node_pop(node);
+}
+
+/*
+ *  readContPids(): read the PIDs of a container CGroup into its cache
+ *
+ *  Arguments: - container CGroup cache entry
+ *
+ *  Return value: 0 on success, -1 on error
+ */
+static int
+readContPids (struct cont_cgrp * cont)
+{
+	char fname[_POSIX_PATH_MAX];
+	char buf[BUFRD];	// read buffer
+	char *pid, *pid_ptr;	// strtok_r variables
+
+	while (cont->pids)
+		node_pop(&cont->pids);
+	cont->dirty = 0;
+
+	(void)snprintf(fname, sizeof(fname), "%s%s/" CGRP_PIDS, prgset->cpusetdfileprefix, cont->dname);
+
+	// prepare literal and open pipe request
+	int fd = open(fname, O_RDONLY);
+	if (0 > fd)
+		return -1;
+
+	int nleft = 0;	// number of bytes left to parse
+	int	ret;		// return value number of bytes read, or error code
+	int count = 0;  // number of PIDS
+
+	// Scan through string and put in array
+	while((ret = read(fd, buf+nleft,BUFRD-nleft-1))) {
+
+		if (0 > ret){ // error..
+			if (EINTR == errno) // retry on interrupt
+				continue;
+			warn("kernel tasks read error!");
+			break;
+		}
 
-						// read success, update bytes to parse
-						nleft += ret;
+		// read success, update bytes to parse
+		nleft += ret;
 
-						printDbg(PIN "PID string return %s\n", buf);
+		printDbg(PIN "PID string return %s\n", buf);
 
-						buf[nleft] = '\0'; // end of read check, nleft = max BUFRD-1;
-						pid = strtok_r (buf,"\n", &pid_ptr);	
+		buf[nleft] = '\0'; // end of read check, nleft = max BUFRD-1;
+		pid = strtok_r (buf,"\n", &pid_ptr);	
 
-						printDbg(PIN "processing"); // Begin line
-						while (NULL != pid && nleft && (6 < (&buf[BUFRD-1]-pid))) { // <6 = 5 pid no + \n
-							// DO STUFF
+		printDbg(PIN "processing"); // Begin line
+		while (NULL != pid && nleft && (6 < (&buf[BUFRD-1]-pid))) { // <6 = 5 pid no + \n
+			// DO STUFF
 
-							node_push(pidlst);
-							// PID found
-							(*pidlst)->pid = atoi(pid);
-							(*pidlst)->status |= MSK_STATSIBL;
-							printDbg("->%d ",(*pidlst)->pid);	// mid line
+			node_push(&cont->pids);
+			// PID found
+			cont->pids->pid = atoi(pid);
+			cont->pids->status |= MSK_STATSIBL;
+			printDbg("->%d ",cont->pids->pid);	// mid line
+
+			updatePidCmdline(cont->pids); // checks and updates..
+
+			nleft -= strlen(pid)+1;
+			pid = strtok_r (NULL,"\n", &pid_ptr);
+			count++;
+		}
+		if (1 == count) // only 1 found, reset sibling flag
+			cont->pids->status &= ~MSK_STATSIBL;
+
+		printDbg("\n"); // end of line
+		if (pid) // copy leftover chars to beginning of string buffer
+			memcpy(buf, buf+BUFRD-nleft-1, nleft); 
+	}
+	close(fd);
+
+	return 0;
+}
+
+/*
+ *  addContCgrp(): add a container CGroup to the cache and watch it
+ *
+ *  Arguments: - CGroup directory name
+ *
+ *  Return value: new cache entry, head of the cache list
+ */
+static struct cont_cgrp *
+addContCgrp (const char * dname)
+{
+	struct cont_cgrp * cont = calloc(1, sizeof(struct cont_cgrp));
+	if (!cont || !(cont->dname = strdup(dname)))
+		err_exit("Could not allocate memory!");
 
-							updatePidCmdline(*pidlst); // checks and updates..
 #ifdef CGROUP2
-							char * name = strdup(dir->d_name);
-							char * tok, *hex;
-							(void)strtok_r(name, "-", &tok);	// 'docker-' part unused
-							hex = strtok_r(NULL, ".", &tok);// &hex pos read, result por to '.scope' set, but overwritten with result - pos unused
+	char * name = strdup(dname);
+	char * tok, *hex;
+	(void)strtok_r(name, "-", &tok);	// 'docker-' part unused
+	hex = strtok_r(NULL, ".", &tok);// &hex pos read, result por to '.scope' set, but overwritten with result - pos unused
 #else
-							char * hex = dir->d_name;
+	const char * hex = dname;
 #endif
-							if (!(( (*pidlst)->contid = strdup(hex) )))
-								err_exit("Could not allocate memory!");
+	if (!hex || !(cont->contid = strdup(hex)))
+		err_exit("Could not allocate memory!");
 #ifdef CGROUP2
-							free(name);
+	free(name);
 #endif
 
-							nleft -= strlen(pid)+1;
-							pid = strtok_r (NULL,"\n", &pid_ptr);
-							count++;
-						}
-						if (1 == count) // only 1 found, reset sibling flag
-							(*pidlst)->status &= ~MSK_STATSIBL;
+	// container start and stop, notification is CGroup v2 only
+	cont->wd = -1;
+	if (0 <= cgrpfd) {
+		char fname[_POSIX_PATH_MAX];
+		(void)snprintf(fname, sizeof(fname), "%s%s/" CGRP_EVTS, prgset->cpusetdfileprefix, dname);
+		cont->wd = inotify_add_watch(cgrpfd, fname, IN_MODIFY);
+	}
 
-						printDbg("\n"); // end of line
-						if (pid) // copy leftover chars to beginning of string buffer
-							memcpy(buf, buf+BUFRD-nleft-1, nleft); 
-					}
-					close(fd);
+	printDbg(PIN "New container CGroup %s\n", dname);
+	cont->dirty = 1;
+	cont->next = cgrphead;
+	cgrphead = cont;
+	return cont;
+}
+
+/*
+ *  delContCgrp(): remove a container CGroup from the cache
+ *
+ *  Arguments: - pointer to the cache entry reference, updated to next
+ *
+ *  Return value: --
+ */
+static void
+delContCgrp (struct cont_cgrp ** cont)
+{
+	struct cont_cgrp * del = *cont;
+	*cont = del->next;
+
+	printDbg(PIN "Removed container CGroup %s\n", del->dname);
+	if (0 <= del->wd)
+		(void)inotify_rm_watch(cgrpfd, del->wd); // fails if gone already
+	while (del->pids)
+		node_pop(&del->pids);
+	free(del->dname);
+	free(del->contid);
+	free(del);
+}
+
+/*
+ *  syncContCgrps(): synchronize the cache with the Docker CGroup directory
+ *
+ *  Arguments: 
+ *
+ *  Return value: 0 on success, -1 if the directory can not be read
+ */
+static int
+syncContCgrps ()
+{
+	struct dirent *dir;
+	DIR *d = opendir(prgset->cpusetdfileprefix);
+	if (!d)
+		return -1;
+
+	for (struct cont_cgrp * cont = cgrphead; ((cont)); cont = cont->next)
+		cont->seen = 0;
+
+	while ((dir = readdir(d)) != NULL) {
+		// scan trough docker CGroups, find them?
+		if ((strlen(dir->d_name)<=60)) // container strings are very long! - KISS as it has to be efficient
+			continue;
 
+		struct cont_cgrp * cont = cgrphead;
+		while ((cont) && strcmp(cont->dname, dir->d_name))
+			cont = cont->next;
+		if (!cont)
+			cont = addContCgrp(dir->d_name);
+		cont->seen = 1;
+	}
+	closedir(d);
+
+	// drop containers no longer present
+	for (struct cont_cgrp ** cont = &cgrphead; ((*cont)); )
+		if (!(*cont)->seen)
+			delContCgrp(cont);
+		else
+			cont = &(*cont)->next;
+
+	return 0;
+}
+
+/*
+ *  readContEvents(): process pending change notifications on the Docker
+ *  			CGroup directory and the containers' events files
+ *
+ *  Arguments: 
+ *
+ *  Return value: 0 on success, -1 if notifications were lost
+ */
+static int
+readContEvents ()
+{
+	char buf[CGRP_EVBUFSZ] __attribute__((aligned(__alignof__(struct inotify_event))));
+	ssize_t len;
+
+	while (0 < (len = read(cgrpfd, buf, sizeof(buf))))
+		for (char * ptr = buf; ptr < buf + len; ) {
+			const struct inotify_event * ev = (const struct inotify_event *)ptr;
+			ptr += sizeof(struct inotify_event) + ev->len;
+
+			if (ev->mask & IN_Q_OVERFLOW)
+				return -1;
+
+			if (ev->wd == cgrpwd) { // container CGroup created or removed
+				if (!ev->len || (strlen(ev->name)<=60))
+					continue;
+
+				struct cont_cgrp ** cont = &cgrphead;
+				while ((*cont) && strcmp((*cont)->dname, ev->name))
+					cont = &(*cont)->next;
+
+				if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+					if (*cont)
+						delContCgrp(cont);
 				}
-				else // FATAL, exit and execute atExit
-					err_exit("Could not allocate memory!");
+				else if (!*cont)
+					(void)addContCgrp(ev->name);
+				continue;
 			}
+
+			// container events file changed, i.e., started or stopped
+			for (struct cont_cgrp * cont = cgrphead; ((cont)); cont = cont->next)
+				if (cont->wd == ev->wd) {
+					cont->dirty = 1;
+					break;
+				}
 		}
-		closedir(d);
 
-		// free string buffers
-		free (fname);
+	return 0;
+}
 
-		return;
+/*
+ *  touchContPids(): mark a cached container CGroup as changed
+ *
+ *  Arguments: - container ID, NULL for all
+ *
+ *  Return value: --
+ */
+static void
+touchContPids (const char * contid)
+{
+	for (struct cont_cgrp * cont = cgrphead; ((cont)); cont = cont->next)
+		if (!contid || !strcmp(cont->contid, contid))
+			cont->dirty = 1;
+}
+
+/*
+ *  freeContPids(): free the container CGroup cache and its watches
+ *
+ *  Arguments: 
+ *
+ *  Return value: --
+ */
+static void
+freeContPids ()
+{
+	while (cgrphead)
+		delContCgrp(&cgrphead);
+	if (0 <= cgrpfd)
+		(void)close(cgrpfd);
+	cgrpfd = -1;
+	cgrpwd = -1;
+	cgrpinit = 0;
+}
+
+/*
+ *  getContPids(): utility function to get PID list of interest from CGroups
+ *
+ *  The directory and the containers' CGroup v2 events files are watched
+ *  for creation, removal, start and stop. Tasks added or removed in a
+ *  running container are not notified by the kernel. With process events
+ *  enabled, only containers that changed are read again; otherwise, all
+ *  containers are read every scan.
+ *
+ *  Arguments: - pointer to linked list storing newly found PIDs
+ *
+ *  Return value: --
+ */
+static void
+getContPids (node_t **pidlst)
+{
+	printDbg(PFX "Container detection!\n");
+
+	if (!cgrpinit) {
+		cgrpinit = 1;
+		cgrpsync = 1;
+		if (0 <= (cgrpfd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+				&& 0 > (cgrpwd = inotify_add_watch(cgrpfd, prgset->cpusetdfileprefix,
+					IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)))
+			printDbg(PFX "Can not watch Docker CGroups, rescanning: %s\n", strerror(errno));
+	}
+
+	if (0 <= cgrpfd && readContEvents())
+		cgrpsync = 1; // notifications lost
+
+	// without directory watch, check for new containers every time
+	if ((cgrpsync) || 0 > cgrpwd) {
+		if (syncContCgrps()) {
+			warn("Can not open Docker CGroups - is the daemon still running?");
+			cont( "switching to container PID detection mode");
+			prgset->use_cgroup = DM_CNTPID; // switch to container pid detection mode
+			freeContPids();
+			return;
+		}
+		if (cgrpsync)
+			touchContPids(NULL);
+		cgrpsync = 0;
 	}
 
-	warn("Can not open Docker CGroups - is the daemon still running?");
-	cont( "switching to container PID detection mode");
-	prgset->use_cgroup = DM_CNTPID; // switch to container pid detection mode
+	for (struct cont_cgrp * cont = cgrphead; ((cont)); cont = cont->next) {
+		// cached only if process events cover task changes
+		if ((cont->dirty) || 0 > cont->wd || 0 > procfd)
+			(void)readContPids(cont);
+
+		// cached PIDs, strings are borrowed from the cache
+		for (node_t * item = cont->pids; ((item)); item = item->next) {
+			node_push(pidlst);
+			(*pidlst)->pid = item->pid;
+			(*pidlst)->status = item->status;
+			(*pidlst)->psig = item->psig;
+			(*pidlst)->contid = cont->contid;
+		}
+	}
+}
+
+// process entry of a /proc walk
+struct proc_ent {
+	pid_t pid;
+	pid_t ppid;
+	char comm[16];	// TASK_COMM_LEN, truncated name
+};
+
+/*
+ *  readProcStat(): read name and parent of a process from /proc/<pid>/stat
+ *
+ *  Arguments: - process entry to fill, PID set
+ *
+ *  Return value: 0 on success, -1 on error (process exited)
+ */
+static int
+readProcStat(struct proc_ent * ent){
+	char kparam[32];
+	char buf[BUFRD];
+
+	(void)sprintf(kparam, "%d/stat", ent->pid);
+	if (0 >= getkernvar("/proc/", kparam, buf, sizeof(buf)))
+		return -1;
+
+	// name is in brackets and may contain spaces or brackets itself
+	char * b = strchr(buf, '(');
+	char * e = strrchr(buf, ')');
+	if (!b || !e || e < b)
+		return -1;
+
+	size_t len = MIN((size_t)(e - b - 1), sizeof(ent->comm) - 1);
+	memcpy(ent->comm, b + 1, len);
+	ent->comm[len] = '\0';
+
+	// ") S ppid ..."
+	if (1 != sscanf(e + 1, " %*c %d", &ent->ppid))
+		return -1;
+	return 0;
+}
+
+/*
+ *  readProcCmdline(): read command line of a process with arguments
+ *  			separated by spaces, as 'ps -o command' does
+ *
+ *  Arguments: - process entry
+ *  		   - buffer, size
+ *
+ *  Return value: length of the command line, 0 if empty (kernel thread)
+ */
+static int
+readProcCmdline(const struct proc_ent * ent, char * buf, int size){
+	char kparam[32];
+	int len;
+
+	(void)sprintf(kparam, "%d/cmdline", ent->pid);
+	if (0 >= (len = getkernvar("/proc/", kparam, buf, size)))
+		return 0;
+
+	// last character is replaced by the terminator, arguments are null separated
+	len--;
+	for (int i = 0; i < len; i++)
+		if ('\0' == buf[i])
+			buf[i] = ' ';
+	while (len && ' ' == buf[len-1])
+		len--;
+	buf[len] = '\0';
+	return len;
+}
+
+/*
+ *  matchProcName(): check if a process matches one of the names in a list,
+ *  			names longer than the kernel task name match on the command
+ *
+ *  Arguments: - process entry
+ *  		   - list of names
+ *  		   - separators of the list
+ *
+ *  Return value: 1 on match, 0 otherwise
+ */
+static int
+matchProcName(const struct proc_ent * ent, const char * names, const char * seps){
+
+	for (const char * tok = names; *tok; ){
+		size_t len = strcspn(tok, seps);
+
+		if (len && !strncmp(tok, ent->comm, MIN(len, sizeof(ent->comm)-1))){
+			if (len < sizeof(ent->comm) - 1){
+				if (len == strlen(ent->comm))
+					return 1;
+			}
+			else {
+				// task name is truncated, compare to executable name
+				char cmd[MAXCMD_LEN];
+				char kparam[32];
+				(void)sprintf(kparam, "%d/cmdline", ent->pid);
+				if (0 < getkernvar("/proc/", kparam, cmd, sizeof(cmd))){
+					cmd[sizeof(cmd)-1] = '\0';
+					char * base = strrchr(cmd, '/');
+					base = (base) ? base + 1 : cmd;
+					if (len == strlen(base) && !strncmp(tok, base, len))
+						return 1;
+				}
+			}
+		}
+
+		tok += len;
+		if (*tok)
+			tok++;
+	}
+	return 0;
+}
+
+/*
+ *  pushProcPid(): add a process or thread to the PID list
+ *
+ *  Arguments: - pointer to linked list of PID
+ * 			   - PID or TID to add
+ * 			   - command line signature
+ * 			   - sibling flag
+ *
+ *  Return value: --
+ */
+static void
+pushProcPid(node_t **pidlst, pid_t pid, const char * cmd, int sibling){
+	node_push(pidlst);
+	(*pidlst)->pid = pid;
+	if (sibling)
+		(*pidlst)->status |= MSK_STATSIBL;
+
+	// add command string to pidlist, borrowed
+	(*pidlst)->psig = internScanStr(cmd);
+	printDbg(PIN "processing->%d cmd: %s\n",(*pidlst)->pid, cmd);
 }
 
 /*
  *  getPids(): utility function to get list of PID for DM_CMDLINE DM_CNTPID mode
+ *  			by walking /proc, in ascending PID order
  *
  *  Arguments: - pointer to linked list of PID
- * 			   - tag string containing the command signature to look for
- * 			   - parent PID if present to note it as sort of container-ID in
+ * 			   - list of process names to look for, comma or pipe separated,
+ * 			     NULL or empty = any
+ * 			   - list of parent PIDs, NULL = any, marks results as siblings
+ * 			   - number of parent PIDs
+ * 			   - scan threads of matching processes, too
  *
  *  Return value: --
  */
 static void
-getPids (node_t **pidlst, char * tag, char * ppid)
+getPids (node_t **pidlst, const char * tag, const pid_t * ppids, int ppidcnt, int threads)
 {
-	FILE *fp;
-
-	{
-		if (!tag) 
-			err_exit("Process signature tag is a null pointer!");
-
-		int tlen = strlen (tag) + 22;
-		char req[tlen];
-		
-		// prepare literal and open pipe request, request spid (thread) ids
-		// spid and pid coincide for main process
-#ifdef BUSYBOX
-		(void)sprintf (req,  "ps -o pid,ppid,comm %s", tag);
-#else
-		(void)sprintf (req,  "ps h -o spid,command %s", tag);
-#endif
-		if(!(fp = popen(req,"r")))
-			return;
+	struct dirent *dir;
+	DIR *d = opendir("/proc/");
+	if (!d){
+		warn("Can not open /proc: %s", strerror(errno));
+		return;
 	}
 
-	char pidline[BUFRD];
-	char *pid, *pid_ptr;
+	char cmd[MAXCMD_LEN];
 	int count = 0;
-	// Scan through string and put in array
-	while(fgets(pidline,BUFRD,fp)) {
-		printDbg(PIN "Pid string return %s", pidline); // needs no \n -> fgets
-		pid = strtok_r (pidline," ", &pid_ptr);
 
-		node_push(pidlst);
-        (*pidlst)->pid = atoi(pid);
-		if (ppid){
-			(*pidlst)->status |= MSK_STATSIBL;
-			(*pidlst)->contid=strdup(ppid);		// string containing the list of parent PIDs
+	while ((dir = readdir(d)) != NULL) {
+		struct proc_ent ent;
+
+		// process directories only
+		if (!(ent.pid = atoi(dir->d_name)) || (readProcStat(&ent)))
+			continue;
+
+		if ((tag) && (*tag) && !matchProcName(&ent, tag, ",|"))
+			continue;
+
+		if (ppids){
+			int i = 0;
+			while (i < ppidcnt && ppids[i] != ent.ppid)
+				i++;
+			if (i == ppidcnt)
+				continue;
 		}
 
-#ifdef BUSYBOX
-		// if busybox, second is ppid
-        pid = strtok_r (NULL, " ", &pid_ptr); // ppid here	
-#endif
-		// find command string and copy to new allocation
-        pid = strtok_r (NULL, "\n", &pid_ptr); // end of line?
-        printDbg(PIN "processing->%d cmd: %s\n",(*pidlst)->pid, pid);
+		// no command line, kernel thread -> use name as ps does
+		if (!readProcCmdline(&ent, cmd, sizeof(cmd)))
+			(void)snprintf(cmd, sizeof(cmd), "[%s]", ent.comm);
+
+		if (!threads){
+			pushProcPid(pidlst, ent.pid, cmd, (ppids != NULL));
+			count++;
+			continue;
+		}
+
+		// thread IDs, main thread TID = PID
+		char tdir[32];
+		(void)sprintf(tdir, "/proc/%d/task/", ent.pid);
+		DIR *t = opendir(tdir);
+		if (!t)
+			continue; // exited meanwhile
+
+		struct dirent *tent;
+		while ((tent = readdir(t)) != NULL) {
+			pid_t tid = atoi(tent->d_name);
+			if (tid){
+				pushProcPid(pidlst, tid, cmd, (ppids != NULL));
+				count++;
+			}
+		}
+		closedir(t);
+	}
+	closedir(d);
 
-		// add command string to pidlist
-		if (!((*pidlst)->psig = strdup(pid))) // alloc memory for string
-			// FATAL, exit and execute atExit
-			err_exit("Could not allocate memory!");
-		(*pidlst)->contid = NULL;
-		count++;
-    }
 	if (1 == count) // only 1 found, reset sibling flag
 		(*pidlst)->status &= ~MSK_STATSIBL;
-
-	pclose(fp);
 }
 
 /*
@@ -236,8 +799,9 @@ getPids (node_t **pidlst, char * tag, char * ppid)
 static void
 getCmdLinePids (node_t **pidlst)
 {
-	// call function with computed signature at start
-	getPids(pidlst, pidSignature, NULL);
+	// threads only if explicitly requested and filtered
+	getPids(pidlst, prgset->cont_pidc, NULL, 0,
+			(prgset->psigscan && strlen (prgset->cont_pidc)));
 }
 /*
  *  getParentPids(): utility function to get list of PID by PPID tag (DM_CNTPID mode)
@@ -249,173 +813,571 @@ getCmdLinePids (node_t **pidlst)
 static void
 getParentPids (node_t **pidlst)
 {
-	char pidline[BUFRD-18];
+	static pid_t * ppids = NULL;
+	static int ppidsz = 0;
+	int ppidcnt = 0;
 
 	if (!prgset->cont_ppidc)
 		err_exit("Process signature tag is a null pointer!");
 
-	int tlen = strlen (prgset->cont_ppidc) + 7;
-	char req[tlen];
+	struct dirent *dir;
+	DIR *d = opendir("/proc/");
+	if (!d){
+		warn("Can not open /proc: %s", strerror(errno));
+		return;
+	}
 
-	// prepare literal and open pipe request
-	(void)sprintf (req,  "pidof %s", prgset->cont_ppidc);
-	FILE *fp;
+	// list of PPIDs, matching names as pidof
+	while ((dir = readdir(d)) != NULL) {
+		struct proc_ent ent;
+		if (!(ent.pid = atoi(dir->d_name)) || (readProcStat(&ent))
+				|| !matchProcName(&ent, prgset->cont_ppidc, " "))
+			continue;
 
-	if(!(fp = popen(req,"r")))
-		return;
+		if (ppidcnt >= ppidsz){
+			ppidsz = MAX(ppidsz * 2, 16);
+			if (!(ppids = realloc(ppids, sizeof(pid_t) * ppidsz)))
+				err_exit("Could not allocate memory!");
+		}
+		ppids[ppidcnt++] = ent.pid;
+	}
+	closedir(d);
 
-	// read list of PPIDs
-	if (fgets(pidline,BUFRD-18,fp)) { // len -10 (+\n), limit maximum (see below)
-		int i=0;
-		// replace space with, for PID list
-		while (pidline[i] && i<BUFRD) {
-			if (' ' == pidline[i]) 
-#ifdef BUSYBOX
-				pidline[i]='|';	// use pipe for regex in grep
-#else
-				pidline[i]=','; // use comma for separated ppid list in standard ps
+	if (ppidcnt)
+		getPids(pidlst, NULL, ppids, ppidcnt, 1);
+}
+
+#define CONT_BATCH	16	// container events handled per dataMutex hold
+
+// container start to CPU-set pinned latency, ns
+static struct {
+	uint64_t cnt;	// started containers with configuration
+	uint64_t pre;	// of which pre-placed at creation
+	uint64_t sum;
+	uint64_t max;
+} contlat;
+
+pthread_t thread_dlink;
+int  iret_dlink; // Timeout is set to 4 seconds by default
+
+/*
+ *  startDockerThread(): start docker verification thread
+ *
+ *  Arguments:
+ *
+ *  Return value: result of pthread_create, negative if failed
+ */
+static int
+startDockerThread() {
+	iret_dlink = pthread_create( &thread_dlink, NULL, dlink_thread_watch, NULL);
+	if (iret_dlink)  // thread not started successfully
+		err_msg_n(iret_dlink, "Failed to start docker_link thread");
+#ifdef DEBUG
+	else
+		(void)pthread_setname_np(thread_dlink, "docker_link");
 #endif
-			i++;
+	return iret_dlink;
+}
+
+/*
+ *  stopDockerThread(): stop docker verification thread
+ *
+ *  Arguments:
+ *
+ *  Return value: result of pthread_*, negative if one failed
+ */
+static int
+stopDockerThread(){
+	// set stop signal
+	int ret = 0;
+	if (!iret_dlink) { // thread started successfully
+		int * dlink_return;
+		if ((iret_dlink = pthread_kill (thread_dlink, SIGHUP))) // tell linking threads to stop
+			err_msg_n(iret_dlink, "Failed to send signal to docker_link thread");
+		ret |= iret_dlink;
+		if ((iret_dlink = pthread_join (thread_dlink, (void**)&dlink_return))) // wait until end
+			err_msg_n(iret_dlink, "Could not join with docker_link thread");
+		ret |= iret_dlink;
+		(void)printf(PFX "Threads stopped\n");
+		if (dlink_overflow)
+			warn("Container event queue was full %lu times", (unsigned long)dlink_overflow);
+		if (contlat.cnt)
+			info("Containers started %lu, %lu pre-placed, start to pinned latency avg %luus max %luus",
+				contlat.cnt, contlat.pre, (contlat.cnt > contlat.pre)
+					? contlat.sum / (contlat.cnt - contlat.pre) / 1000 : 0, contlat.max / 1000);
+	}
+	return ret;
+}
+
+/*
+ *  contStarted(): account start to pinned latency of a container
+ *
+ *  Arguments: - container node after setPidResources
+ *  		   - start event timestamp, ns realtime
+ *
+ *  Return value: --
+ */
+static void
+contStarted(node_t * node, uint64_t timenano) {
+
+	if (!node->param || !node->param->cont || !(node->status & MSK_STATUPD))
+		return;
+
+	contlat.cnt++;
+	if (node->param->cont->status & MSK_STATCPRE) {
+		// pinned before the first task ran, next create places again
+		node->param->cont->status &= ~MSK_STATCPRE;
+		contlat.pre++;
+		return;
+	}
+
+	struct timespec now;
+	(void)clock_gettime(CLOCK_REALTIME, &now);
+	uint64_t lat = (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+	lat = (lat > timenano) ? lat - timenano : 0;
+	contlat.sum += lat;
+	contlat.max = MAX(contlat.max, lat);
+}
+
+/*
+ *  updateDocker(): pull event from dockerlink and verify
+ *
+ *  Arguments:
+ *
+ *  Return value:
+ */
+static void
+updateDocker() {
+
+	contevent_t evnts[CONT_BATCH];
+	int cnt = dlink_pop(evnts, CONT_BATCH);
+
+	if (!cnt)
+		return;
+
+	// drain queue in batches, one lock per batch, Engine API calls unlocked
+	contevent_t * lstevent = evnts;
+	while (cnt) {
+		cont_t * place = NULL;		// container configuration to pre-place
+		char * placeid = NULL;		// its container ID
+		char affinity[CPUSTRLEN];	// and CPU-set
+
+		(void)pthread_mutex_lock(&dataMutex);
+		for (; lstevent < evnts + cnt && !place; lstevent++)
+			// process data, find PID entry
+			switch (lstevent->event) {
+				case cnt_create:
+				case cnt_add:
+					// do nothing, call for PIDs
+					// update container break
+					// settings;
+					;
+					node_t * linked = NULL;
+					node_push(&linked);
+					linked->pid = 0; // impossible id -> sets value for count only
+					linked->psig = lstevent->name; // used to store container name just for find
+					linked->contid = lstevent->id;
+					linked->imgid = lstevent->image;
+
+					// both call findPidParameters with write access to configuration
+					if (cnt_create == lstevent->event) {
+						// place after unlock, stops the batch until then
+						if (!getContainerPlacement(linked, affinity)) {
+							place = linked->param->cont;
+							if (!(placeid = strdup(linked->contid)))
+								err_exit("Could not allocate memory!");
+						}
+					}
+					else {
+						setPidResources(linked);
+						contStarted(linked, lstevent->timenano);
+					}
+
+					free(linked->param);
+					linked->param = NULL;
+
+					node_pop(&linked);
+					break;
+
+				case cnt_remove: ;
+					printDbg(PFX "Container removal posted for %.12s", lstevent->id);
+					node_t dummy = {nhead};
+					node_t * curr = &dummy;
+
+					// drop matching PIDs of this container
+					while (((curr->next))){
+						if (curr->next->contid && lstevent->id
+								&& !strcmp(curr->next->contid, lstevent->id)){
+							releasePidCPU(curr->next);
+							if (prgset->trackpids){		// deactivate only
+								node_idxDel(curr->next);
+								curr->next->pid = abs(curr->next->pid) * -1;
+							}
+							else {
+								node_pop(&curr->next);
+								continue; // don't move on to next item
+							}
+						}
+						curr=curr->next;
+					}
+					nhead = dummy.next;
+					// no break
+
+				default:
+				case cnt_pending:
+					// clear event, do nothing
+					free(lstevent->name);
+					free(lstevent->id);
+					free(lstevent->image);
+					break;
+			}
+		(void)pthread_mutex_unlock(&dataMutex);
+
+		// synchronous Engine API call, outside the data lock
+		if ((place) && !setContainerPlacement(placeid, affinity)) {
+			(void)pthread_mutex_lock(&dataMutex);
+			place->status |= MSK_STATCPRE;
+			(void)pthread_mutex_unlock(&dataMutex);
 		}
+		free(placeid);
 
-#ifdef BUSYBOX
-		char pids[BUFRD];
-		(void)sprintf(pids, "-T | grep -E '%s'", pidline); // len = 17, sum = total buffer
-#else
-		char pids[BUFRD] = "-T --ppid "; // len = 10, sum = total buffer
-		(void)strcat(pids, pidline);
-#endif
-		pids[strlen(pids)-1]='\0'; // just to be sure.. terminate with null-char, overwrite \n
+		// batch done, pull next
+		if (lstevent >= evnts + cnt) {
+			cnt = dlink_pop(evnts, CONT_BATCH);
+			lstevent = evnts;
+		}
+	}
+
+	// scan for PID updates
+	scanNew(); 
+}
 
-		getPids(pidlst, pids, pidline);
+/*
+ *  getReplayPids(): get PID list of a recorded trace, replay mode
+ *
+ *  The record is applied up to the trace time reached by the replay, so
+ *  that PIDs enter and leave the list as they did while recording.
+ *
+ *  Arguments: - pointer to linked list storing found PIDs
+ *
+ *  Return value: --
+ */
+static void
+getReplayPids (node_t **pidlst)
+{
+	uint64_t now = getTraceTime();
+
+	if (!pidplay) {
+		char fn[_POSIX_PATH_MAX];
+
+		(void)snprintf(fn, sizeof(fn), "%s/" TR_REC_PIDS, prgset->trace_play);
+		if (!(pidplay = fopen(fn, "r"))){
+			printDbg(PFX "No PIDs in trace record\n");
+			return;
+		}
+	}
+
+	// apply records up to the trace time, keep the first one ahead
+	while ((pidplaypend) || (fgets(pidplayln, sizeof(pidplayln), pidplay))){
+		uint64_t ts;
+		char op;
+		int len = 0;
+
+		pidplaypend = 0;
+		if (2 != sscanf(pidplayln, "%lu %c %n", &ts, &op, &len) || !len)
+			continue;
+		if (ts > now){
+			pidplaypend = 1;
+			break;
+		}
+
+		char * tok;
+		char * pid = strtok_r(pidplayln + len, " \n", &tok);
+		if (!pid || 0 >= atoi(pid))
+			continue;
+
+		node_t ** item = &pidplaylst;
+		while ((*item) && (*item)->pid != atoi(pid))
+			item = &(*item)->next;
+
+		if ('-' == op){
+			if (*item)
+				node_pop(item);
+			continue;
+		}
+
+		char * contid = strtok_r(NULL, " \n", &tok);
+		char * imgid = strtok_r(NULL, " \n", &tok);
+		char * psig = strtok_r(NULL, "\n", &tok);
+
+		if ('+' != op || !imgid || (*item)) // recorded again after restart
+			continue;
+
+		node_push(&pidplaylst);
+		pidplaylst->pid = atoi(pid);
+		if ((strcmp(contid, "-") && !(pidplaylst->contid = strdup(contid)))
+				|| (strcmp(imgid, "-") && !(pidplaylst->imgid = strdup(imgid)))
+				|| ((psig) && !(pidplaylst->psig = strdup(psig))))
+			err_exit("Could not allocate memory!");
+	}
+
+	// PIDs alive, strings are borrowed from the replay list
+	for (node_t * item = pidplaylst; ((item)); item = item->next) {
+		node_push(pidlst);
+		(*pidlst)->pid = item->pid;
+		(*pidlst)->psig = item->psig;
+		(*pidlst)->contid = item->contid;
+		(*pidlst)->imgid = item->imgid;
 	}
-	pclose(fp);
 }
 
-static contevent_t * lstevent;
-pthread_t thread_dlink;
-int  iret_dlink; // Timeout is set to 4 seconds by default
+/*
+ *  freeReplayPids(): close the replayed PID record and free its PID list
+ *
+ *  Arguments:
+ *
+ *  Return value:
+ */
+static void
+freeReplayPids () {
+	if (pidplay)
+		(void)fclose(pidplay);
+	pidplay = NULL;
+	pidplaypend = 0;
+	while (pidplaylst)
+		node_pop(&pidplaylst);
+}
+
+/*
+ *  openPidRecord(): create the PID record of a trace recording
+ *
+ *  Arguments:
+ *
+ *  Return value:
+ */
+static void
+openPidRecord () {
+	char fn[_POSIX_PATH_MAX];
+
+	if (mkdir(prgset->trace_rec, 0755) && EEXIST != errno){
+		warn("Unable to create trace record directory '%s': %s", prgset->trace_rec, strerror(errno));
+		return;
+	}
+
+	(void)snprintf(fn, sizeof(fn), "%s/" TR_REC_PIDS, prgset->trace_rec);
+	if (!(pidrec = fopen(fn, "w"))){
+		warn("Unable to record tracked PIDs: %s", strerror(errno));
+		return;
+	}
+
+	if (!(pidrecbuf = malloc(TR_REC_BUFSZ)))
+		err_exit("Could not allocate memory!");
+	pidrecsz = TR_REC_BUFSZ;
+	pidreclen = 0;
+}
+
+/*
+ *  recordPidLine(): append a line to the PID record buffer
+ *
+ *  Arguments: - format string and arguments, as printf
+ *
+ *  Return value:
+ */
+static void
+recordPidLine (const char * fmt, ...) {
+	va_list ap;
+	int len;
+
+	for (;;) {
+		va_start(ap, fmt);
+		len = vsnprintf(pidrecbuf + pidreclen, pidrecsz - pidreclen, fmt, ap);
+		va_end(ap);
+		if (0 > len || pidreclen + len < pidrecsz)
+			break;
+
+		// grow and format again
+		pidrecsz = MAX(pidrecsz * 2, pidreclen + len + 1);
+		if (!(pidrecbuf = realloc(pidrecbuf, pidrecsz)))
+			err_exit("Could not allocate memory!");
+	}
+	if (0 < len)
+		pidreclen += len;
+}
+
+/*
+ *  recordPid(): buffer a record of a newly tracked PID, see writePidRecord()
+ *
+ *  Arguments: - PID node, before its resources are set
+ *
+ *  Return value:
+ */
+static void
+recordPid (node_t * node) {
+	if (!pidrec)
+		return;
+	recordPidLine("%lu + %d %s %s %s\n", getTraceTime(), node->pid,
+			(node->contid) ? node->contid : "-",
+			(node->imgid) ? node->imgid : "-",
+			(node->psig) ? node->psig : "");
+}
+
+/*
+ *  recordPidExit(): buffer a record of a PID that left, see writePidRecord()
+ *
+ *  Arguments: - PID
+ *
+ *  Return value:
+ */
+static void
+recordPidExit (pid_t pid) {
+	if (!pidrec || 0 >= pid) // deactivated already
+		return;
+	recordPidLine("%lu - %d\n", getTraceTime(), pid);
+}
+
+/*
+ *  writePidRecord(): write the buffered PID records, without holding the
+ *  			data lock
+ *
+ *  Arguments:
+ *
+ *  Return value:
+ */
+static void
+writePidRecord () {
+	if (!pidrec || !pidreclen)
+		return;
+	(void)fwrite(pidrecbuf, pidreclen, 1, pidrec);
+	(void)fflush(pidrec);
+	pidreclen = 0;
+}
 
 /*
- *  startDockerThread(): start docker verification thread
+ *  closePidRecord(): write pending records and close the PID record
  *
  *  Arguments:
  *
- *  Return value: result of pthread_create, negative if failed
+ *  Return value:
  */
-static int
-startDockerThread() {
-	iret_dlink = pthread_create( &thread_dlink, NULL, dlink_thread_watch, NULL);
-	if (iret_dlink)  // thread not started successfully
-		err_msg_n(iret_dlink, "Failed to start docker_link thread");
-#ifdef DEBUG
-	else
-		(void)pthread_setname_np(thread_dlink, "docker_link");
-#endif
-	return iret_dlink;
+static void
+closePidRecord () {
+	if (!pidrec)
+		return;
+	writePidRecord();
+	(void)fclose(pidrec);
+	pidrec = NULL;
+	free(pidrecbuf);
+	pidrecbuf = NULL;
+	pidrecsz = pidreclen = 0;
 }
 
 /*
- *  stopDockerThread(): stop docker verification thread
+ *  initPidWatches(): cap the pidfds to a share of the file descriptor limit
  *
  *  Arguments:
  *
- *  Return value: result of pthread_*, negative if one failed
+ *  Return value: --
  */
-static int
-stopDockerThread(){
-	// set stop signal
-	int ret = 0;
-	if (!iret_dlink) { // thread started successfully
-		int * dlink_return;
-		if ((iret_dlink = pthread_kill (thread_dlink, SIGHUP))) // tell linking threads to stop
-			err_msg_n(iret_dlink, "Failed to send signal to docker_link thread");
-		ret |= iret_dlink;
-		if ((iret_dlink = pthread_join (thread_dlink, (void**)&dlink_return))) // wait until end
-			err_msg_n(iret_dlink, "Could not join with docker_link thread");
-		ret |= iret_dlink;
-		(void)printf(PFX "Threads stopped\n");
-	}
-	return ret;
+static void
+initPidWatches () {
+	struct rlimit rlim;
+
+	pidfdmax = PIDFD_MAXFDS;
+	pidfdmiss = 0;
+	if (!getrlimit(RLIMIT_NOFILE, &rlim) && RLIM_INFINITY != rlim.rlim_cur)
+		pidfdmax = MIN(pidfdmax, (int)(rlim.rlim_cur / PIDFD_FDSHARE));
+	printDbg(PFX "Watching up to %d PIDs with pidfds\n", pidfdmax);
 }
 
 /*
- *  updateDocker(): pull event from dockerlink and verify
+ *  watchPid(): open a pidfd to be notified when a managed PID exits
  *
- *  Arguments:
+ *  Arguments: - PID (TID)
  *
- *  Return value:
+ *  Return value: --
  */
 static void
-updateDocker() {
-	
-	// NOTE: pointers are atomic
-	if (!containerEvent)
+watchPid (pid_t pid) {
+#ifdef SYS_pidfd_open
+	if (!pidfdon)
 		return;
-	
-	while (containerEvent) {	
-		lstevent = containerEvent;
-		containerEvent = NULL;
-		// process data, find PID entry
-
-		switch (lstevent->event) {
-			case cnt_add:
-				// do nothing, call for PIDs
-				// update container break
-				// settings;
-				;
-				node_t * linked = NULL;
-				node_push(&linked);
-				linked->pid = 0; // impossible id -> sets value for count only
-				linked->psig = lstevent->name; // used to store container name just for find
-				linked->contid = lstevent->id;
-				linked->imgid = lstevent->image;
-
-				free(lstevent);
-				lstevent = NULL;
-
-				// setPidResources calls findPidParameters with write access to configuration - but lock may not be needed
-				(void)pthread_mutex_lock(&dataMutex);
-				setPidResources(linked);
-				(void)pthread_mutex_unlock(&dataMutex);
-
-				free(linked->param);
-				linked->param = NULL;
-
-				node_pop(&linked);
-				break;
 
-			case cnt_remove: ;
-				(void)pthread_mutex_lock(&dataMutex);
-				printDbg(PFX "Container removal posted for %.12s", lstevent->id);
-				node_t dummy = {nhead};
-				node_t * curr = &dummy;
-
-				// drop matching PIDs of this container
-				while (((curr->next))){
-					if (curr->next->contid == lstevent->id){
-						if (prgset->trackpids)		// deactivate only
-							curr->next->pid = abs(curr->next->pid) * -1;
-						else {
-							node_pop(&curr->next);
-							continue; // don't move on to next item
-						}
-					}
-					curr=curr->next;
-				}
-				(void)pthread_mutex_unlock(&dataMutex);
-				break;
+	if (pidfdcnt >= pidfdmax) {
+		pidfdmiss++; // above the cap, exit detected by scans
+		return;
+	}
 
-			default:
-			case cnt_pending:
-				// clear last event, do nothing
-				free(lstevent);
-				break;
+	// threads need PIDFD_THREAD, older kernels accept group leaders only
+	int fd = syscall(SYS_pidfd_open, pid, PIDFD_THREAD);
+	if (0 > fd && EINVAL == errno)
+		fd = syscall(SYS_pidfd_open, pid, 0);
+	if (0 > fd) {
+		if (ENOSYS == errno) {
+			printDbg(PFX "pidfds not available, periodic scans only\n");
+			pidfdon = 0;
+			return;
 		}
+		if (EMFILE == errno || ENFILE == errno) {
+			// out of fds, keep the watched ones, scan for the others
+			warn("Out of file descriptors, watching %d PIDs only", pidfdcnt);
+			pidfdmax = pidfdcnt;
+		}
+		pidfdmiss++;
+		return; // exited meanwhile or no thread support, next scan
 	}
 
-	// scan for PID updates
-	scanNew(); 
+	if (pidfdcnt >= pidfdsz) {
+		pidfdsz = MAX(pidfdsz * 2, 16);
+		if (!(evpoll = realloc(evpoll, (pidfdsz + 1) * sizeof(struct pollfd)))
+				|| !(evpollpid = realloc(evpollpid, (pidfdsz + 1) * sizeof(pid_t))))
+			err_exit("Could not allocate memory!");
+	}
+
+	pidfdcnt++;
+	evpoll[pidfdcnt] = (struct pollfd){ fd, POLLIN, 0 };
+	evpollpid[pidfdcnt] = pid;
+#endif
+}
+
+/*
+ *  unwatchPid(): close the pidfd of a PID, if any
+ *
+ *  Arguments: - PID (TID)
+ *
+ *  Return value: --
+ */
+static void
+unwatchPid (pid_t pid) {
+	for (int i = 1; i <= pidfdcnt; i++)
+		if (evpollpid[i] == pid) {
+			(void)close(evpoll[i].fd);
+			// move last to free slot
+			evpoll[i] = evpoll[pidfdcnt];
+			evpollpid[i] = evpollpid[pidfdcnt];
+			pidfdcnt--;
+			return;
+		}
+	if (pidfdmiss)
+		pidfdmiss--; // PID had no pidfd
+}
+
+/*
+ *  freePidWatches(): close all pidfds and free the poll set
+ *
+ *  Arguments:
+ *
+ *  Return value: --
+ */
+static void
+freePidWatches () {
+	while (pidfdcnt)
+		(void)close(evpoll[pidfdcnt--].fd);
+	pidfdmiss = 0;
+	free(evpoll);
+	free(evpollpid);
+	evpoll = NULL;
+	evpollpid = NULL;
+	pidfdsz = 0;
 }
 
 /*
@@ -472,7 +1434,11 @@ scanNew () {
 			node_t * tmp = tail->next;
 			tail->next = lnew;
 
+			ownScanPid(lnew);
+			recordPid(lnew);
 			setPidResources(lnew); // find match and set resources
+			node_idxAdd(lnew);
+			watchPid(lnew->pid);
 
 			// skip to next node, then overwrite added next ref
 			lnew = lnew->next;
@@ -491,7 +1457,11 @@ scanNew () {
 			}
 
 			printDbg(PIN "... Delete %d\n", tail->next->pid);
+			unwatchPid(tail->next->pid);
+			recordPidExit(tail->next->pid);
+			releasePidCPU(tail->next);
 			if (prgset->trackpids){ // deactivate only
+				node_idxDel(tail->next);
 				tail->next->pid*=-1;
 				tail = tail->next;
 			}
@@ -505,15 +1475,19 @@ scanNew () {
 		// ok, they're equal, skip to next
 		printDbg(PIN "... No change\n");
 		// free allocated items, no longer needed
-		node_pop(&lnew);
+		popScanPid(&lnew);
 		tail = tail->next;
 	}
 
 	while (NULL != tail->next) { // reached the end of the pid queue -- drop list end
 		// drop missing items
 		printDbg(PIN "... Delete at end %d\n", tail->next->pid);// tail->next->pid);
+		unwatchPid(tail->next->pid);
+		recordPidExit(tail->next->pid);
+		releasePidCPU(tail->next);
 		// get next item, then drop old
 		if (prgset->trackpids){// deactivate only
+			node_idxDel(tail->next);
 			tail->next->pid = abs(tail->next->pid)*-1;
 			tail = tail->next;
 		}
@@ -528,7 +1502,11 @@ scanNew () {
 		printDbg(PIN "... Insert at end, starting from PID %d - on\n", lnew->pid);
 		tail->next = lnew;
 		while (tail->next){
+			ownScanPid(tail->next);
+			recordPid(tail->next);
 			setPidResources(tail->next); // find match and set resources
+			node_idxAdd(tail->next);
+			watchPid(tail->next->pid);
 			tail=tail->next;
 		}
 	}
@@ -539,6 +1517,11 @@ scanNew () {
 	// unlock data thread
 	(void)pthread_mutex_unlock(&dataMutex);
 
+	// all borrowed strings are copied or dropped
+	sweepScanStrs();
+
+	writePidRecord();
+
 	printDbg(PFX "Exiting node update\n");
 
 #ifdef DEBUG
@@ -556,6 +1539,427 @@ scanNew () {
 		setContCGroups(prgset, 0);
 }
 
+/*
+ *  insertPid(): insert a single new PID into the PID list and set its
+ *  			resources, as scanNew() does for new PIDs
+ *
+ *  Arguments: - PID node, freed if already present
+ *
+ *  Return value: 0 if inserted, -1 if already present
+ */
+static int
+insertPid (node_t * item) {
+
+	// lock data to avoid inconsistency
+	(void)pthread_mutex_lock(&dataMutex);
+	int wasEmpty = (!nhead);
+
+	if (node_idxGet(item->pid)){
+		(void)pthread_mutex_unlock(&dataMutex);
+		node_pop(&item);
+		return -1;
+	}
+
+	node_t	dummy = { nhead }; // dummy placeholder for head list
+	node_t	*tail = &dummy;	  // pointer to tail element
+
+	// list is descending, deactivated PIDs are negative
+	while ((tail->next) && abs(tail->next->pid) > item->pid)
+		tail = tail->next;
+
+	if ((tail->next) && abs(tail->next->pid) == item->pid){
+		printDbg(PIN "... Dropping deactivated PID %d\n", item->pid);
+		node_pop(&tail->next);
+	}
+
+	printDbg(PIN "... Insert new PID %d\n", item->pid);
+	item->next = tail->next;
+	tail->next = item;
+	nhead = dummy.next;
+
+	recordPid(item);
+	setPidResources(item); // find match and set resources
+	node_idxAdd(item);
+	watchPid(item->pid);
+
+	// unlock data thread
+	(void)pthread_mutex_unlock(&dataMutex);
+
+	writePidRecord();
+
+	if (wasEmpty)
+		setContCGroups(prgset, 0);
+	return 0;
+}
+
+/*
+ *  removePid(): drop or deactivate a PID that exited, as scanNew() does,
+ *  			and update the utilization of its CPU right away
+ *
+ *  Arguments: - PID
+ *
+ *  Return value: --
+ */
+static void
+removePid (pid_t pid) {
+
+	// lock data to avoid inconsistency
+	(void)pthread_mutex_lock(&dataMutex);
+
+	unwatchPid(pid);
+	node_t * item = node_idxGet(pid);
+	if (!item){
+		(void)pthread_mutex_unlock(&dataMutex);
+		return;
+	}
+
+	printDbg(PIN "... Delete %d\n", pid);
+	recordPidExit(pid);
+	if (item->contid)
+		touchContPids(item->contid); // cached PIDs are outdated
+	// leave the resource tracer
+	releasePidCPU(item);
+	if (prgset->trackpids){ // deactivate only
+		node_idxDel(item);
+		item->pid *= -1;
+	}
+	else{
+		node_t	dummy = { nhead }; // dummy placeholder for head list
+		node_t	*tail = &dummy;	  // pointer to tail element
+		while (tail->next != item)
+			tail = tail->next;
+		node_pop(&tail->next);
+		nhead = dummy.next;
+	}
+
+	// unlock data thread
+	(void)pthread_mutex_unlock(&dataMutex);
+
+	writePidRecord();
+
+	// docker bypass problem of cpuset.cpu reset if no container is set
+	if (!nhead)
+		resetContCGroups(prgset, prgset->affinity, prgset->numa);
+}
+
+/*
+ *  getProcContid(): get container ID of a process from its CGroup path
+ *
+ *  Arguments: - PID
+ *
+ *  Return value: container ID, NULL if not in a container CGroup
+ */
+static char *
+getProcContid (pid_t pid) {
+	char kparam[32];
+	char buf[BUFRD*4];
+
+	(void)sprintf(kparam, "%d/cgroup", pid);
+	if (0 >= getkernvar("/proc/", kparam, buf, sizeof(buf)))
+		return NULL;
+
+	// path relative to CGroup root, e.g. 0::/system.slice/docker-<id>.scope
+	char * name = buf;
+	size_t clen = strlen(prgset->cont_cgrp);
+	while ((name = strstr(name, prgset->cont_cgrp))){
+		if (name > buf && '/' == name[-1])
+			break;
+		name += clen;
+	}
+	if (!name)
+		return NULL;
+	name += clen;
+	name[strcspn(name, "/\n")] = '\0';
+
+	if (60 >= strlen(name)) // container strings are very long!
+		return NULL;
+
+#ifdef CGROUP2
+	if (!strncmp(name, CGRP_DCKP, strlen(CGRP_DCKP)))
+		name += strlen(CGRP_DCKP);
+	name[strcspn(name, ".")] = '\0'; // '.scope' suffix
+#endif
+	return strdup(name);
+}
+
+/*
+ *  getProcNode(): create a PID node for a new process or thread if it
+ *  			matches the detection mode
+ *
+ *  Arguments: - PID (TID) of the new task
+ *  		   - thread group (process) ID of the task
+ *
+ *  Return value: new PID node, NULL if no match
+ */
+static node_t *
+getProcNode (pid_t pid, pid_t tgid) {
+	struct proc_ent ent = { tgid };
+	char * contid = NULL;
+
+	if (readProcStat(&ent))
+		return NULL; // exited meanwhile
+
+	switch (prgset->use_cgroup) {
+
+		case DM_CGRP: // detect by CGroup
+			if (!(contid = getProcContid(tgid)))
+				return NULL;
+			break;
+
+		case DM_CNTPID: // detect by container shim pid, threads included
+			{
+				struct proc_ent parent = { ent.ppid };
+				if ((readProcStat(&parent)) || !matchProcName(&parent, prgset->cont_ppidc, " "))
+					return NULL;
+			}
+			break;
+
+		case DM_CMDLINE:
+		default: // detect by pid signature
+			if (strlen(prgset->cont_pidc) && !matchProcName(&ent, prgset->cont_pidc, ",|"))
+				return NULL;
+			if (pid != tgid && !(prgset->psigscan && strlen(prgset->cont_pidc)))
+				return NULL;
+			break;
+	}
+
+	node_t * item = NULL;
+	node_push(&item);
+	item->pid = pid;
+	item->contid = contid;
+
+	if (contid)
+		updatePidCmdline(item); // as CGroup scan
+	else {
+		char cmd[MAXCMD_LEN];
+		if (!readProcCmdline(&ent, cmd, sizeof(cmd)))
+			(void)snprintf(cmd, sizeof(cmd), "[%s]", ent.comm);
+		if (!(item->psig = strdup(cmd)))
+			err_exit("Could not allocate memory!");
+	}
+	return item;
+}
+
+/*
+ *  handleProcEvent(): add or drop a PID on a kernel process event
+ *
+ *  Arguments: - process event
+ *
+ *  Return value: 1 if a PID was added, 0 otherwise
+ */
+static int
+handleProcEvent (const struct proc_event * ev) {
+	pid_t pid, tgid;
+
+	switch (ev->what) {
+		case PROC_EVENT_FORK:
+			pid = ev->event_data.fork.child_pid;
+			tgid = ev->event_data.fork.child_tgid;
+			break;
+
+		case PROC_EVENT_EXEC: // name and command line changed
+			pid = ev->event_data.exec.process_pid;
+			tgid = ev->event_data.exec.process_tgid;
+			break;
+
+		case PROC_EVENT_EXIT:
+			removePid(ev->event_data.exit.process_pid);
+			return 0;
+
+		default:
+			return 0;
+	}
+
+	node_t * item = getProcNode(pid, tgid);
+	if (!item)
+		return 0;
+	if (item->contid)
+		touchContPids(item->contid); // cached PIDs are outdated
+	if (insertPid(item))
+		return 0;
+
+	// time from event to configured PID, event time-stamp is monotonic
+	struct timespec now;
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	uint64_t lat = (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec - ev->timestamp_ns;
+	proclat.cnt++;
+	proclat.sum += lat;
+	proclat.max = MAX(proclat.max, lat);
+	printDbg(PFX "PID %d configured %luus after process event\n", pid, lat/1000);
+
+	return 1;
+}
+
+/*
+ *  sendProcOp(): send a multicast operation to the process connector
+ *
+ *  Arguments: - PROC_CN_MCAST_LISTEN or PROC_CN_MCAST_IGNORE
+ *
+ *  Return value: 0 on success, -1 on error
+ */
+static int
+sendProcOp (enum proc_cn_mcast_op op) {
+	struct {
+		struct nlmsghdr hdr;
+		struct cn_msg msg;
+		enum proc_cn_mcast_op op;
+	} __attribute__((packed)) req;
+
+	(void)memset(&req, 0, sizeof(req));
+	req.hdr.nlmsg_len = sizeof(req);
+	req.hdr.nlmsg_type = NLMSG_DONE;
+	req.msg.id.idx = CN_IDX_PROC;
+	req.msg.id.val = CN_VAL_PROC;
+	req.msg.len = sizeof(op);
+	req.op = op;
+
+	return (0 > send(procfd, &req, sizeof(req), 0)) ? -1 : 0;
+}
+
+/*
+ *  openProcEvents(): subscribe to kernel process events
+ *
+ *  Arguments:
+ *
+ *  Return value: 0 on success, -1 on error (periodic scans only)
+ */
+static int
+openProcEvents () {
+	struct sockaddr_nl addr = { .nl_family = AF_NETLINK, .nl_groups = CN_IDX_PROC };
+
+	if (0 > (procfd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR))
+			|| (bind(procfd, (struct sockaddr *)&addr, sizeof(addr)))
+			|| (sendProcOp(PROC_CN_MCAST_LISTEN))){
+		warn("Process events not available, periodic scans only: %s", strerror(errno));
+		if (0 <= procfd)
+			(void)close(procfd);
+		procfd = -1;
+		return -1;
+	}
+
+	cont("Listening to process events for new PIDs");
+	return 0;
+}
+
+/*
+ *  closeProcEvents(): unsubscribe from kernel process events
+ *
+ *  Arguments:
+ *
+ *  Return value:
+ */
+static void
+closeProcEvents () {
+	if (0 > procfd)
+		return;
+
+	(void)sendProcOp(PROC_CN_MCAST_IGNORE);
+	(void)close(procfd);
+	procfd = -1;
+
+	if (proclat.cnt)
+		info("Process events added %lu PIDs, latency avg %luus max %luus", proclat.cnt,
+				proclat.sum / proclat.cnt / 1000, proclat.max / 1000);
+}
+
+/*
+ *  readProcEvents(): process all pending kernel process events
+ *
+ *  Arguments:
+ *
+ *  Return value: number of PIDs added, -1 if events were lost
+ */
+static int
+readProcEvents () {
+	char buf[PROCEV_BUFSZ] __attribute__((aligned(NLMSG_ALIGNTO)));
+	int cnt = 0;
+	ssize_t len;
+
+	while (0 < (len = recv(procfd, buf, sizeof(buf), MSG_DONTWAIT)))
+		for (struct nlmsghdr * hdr = (struct nlmsghdr *)buf; NLMSG_OK(hdr, len);
+				hdr = NLMSG_NEXT(hdr, len)){
+			if (NLMSG_ERROR == hdr->nlmsg_type || NLMSG_NOOP == hdr->nlmsg_type)
+				continue;
+
+			struct cn_msg * msg = NLMSG_DATA(hdr);
+			if (CN_IDX_PROC != msg->id.idx || CN_VAL_PROC != msg->id.val)
+				continue;
+
+			cnt += handleProcEvent((struct proc_event *)msg->data);
+		}
+
+	// socket buffer overrun, events missing
+	if (0 > len && ENOBUFS == errno){
+		printDbg(PFX "Process events lost, rescan\n");
+		touchContPids(NULL);
+		return -1;
+	}
+	return cnt;
+}
+
+/*
+ *  pollEvents(): wait for and handle process events and exits of managed
+ *  			PIDs
+ *
+ *  Arguments: - relative timeout, zero to return immediately
+ *
+ *  Return value: -1 on error, 0 otherwise
+ */
+static int
+pollEvents (const struct timespec * timeout) {
+	struct pollfd pfd;
+
+	// process events only, poll set not allocated yet
+	struct pollfd * fds = (evpoll) ? evpoll : &pfd;
+	fds[0] = (struct pollfd){ procfd, POLLIN, 0 }; // ignored if -1
+
+	int ret = ppoll(fds, pidfdcnt + 1, timeout, NULL);
+	if (0 > ret){
+		if (EINTR == errno)
+			return 0;
+		warn("ppoll() failed. errno: %s", strerror (errno));
+		return -1;
+	}
+	if (!ret)
+		return 0;
+
+	if ((fds[0].revents) && 0 > readProcEvents())
+		scanNew(); // events lost, catch up
+
+	// exited PIDs, backwards as removal moves the last pidfd here
+	for (int i = pidfdcnt; i > 0; i--)
+		if (evpoll[i].revents)
+			removePid(evpollpid[i]);
+
+	return 0;
+}
+
+/*
+ *  waitEvents(): wait for the next interval, handling process events and
+ *  			exits of managed PIDs as they arrive
+ *
+ *  Arguments: - absolute time of the next interval
+ *
+ *  Return value:
+ */
+static void
+waitEvents (const struct timespec * until) {
+	struct timespec now;
+
+	while (!clock_gettime(clocksources[prgset->clocksel], &now)
+			&& (now.tv_sec < until->tv_sec
+				|| (now.tv_sec == until->tv_sec && now.tv_nsec < until->tv_nsec))) {
+
+		struct timespec rel = { until->tv_sec - now.tv_sec, until->tv_nsec - now.tv_nsec };
+		if (0 > rel.tv_nsec){
+			rel.tv_nsec += NSEC_PER_SEC;
+			rel.tv_sec--;
+		}
+		if (pollEvents(&rel))
+			return;
+	}
+}
+
 /*
  *  selectUpdate(): select function and generate signature for update
  *
@@ -565,6 +1969,11 @@ scanNew () {
  */
 static void
 selectUpdate () {
+	if (prgset->trace_play) { // offline, PIDs of the record
+		pidUpdate = getReplayPids;
+		return;
+	}
+
 	switch (prgset->use_cgroup) {
 
 		case DM_CGRP: // detect by CGroup
@@ -576,28 +1985,8 @@ selectUpdate () {
 			break;
 
 		case DM_CMDLINE:
-		default: ;// detect by pid signature
-
-			// Generate PID signature to look for!
-			pidSignature = malloc(CMD_LEN);
-			pidSignature[0] = '\0';
-
-	#ifdef BUSYBOX
-			if (prgset->psigscan && strlen (prgset->cont_pidc))
-				(void)sprintf(pidSignature, "-T | grep -E '%s'", prgset->cont_pidc);
-			else if (strlen (prgset->cont_pidc))
-				(void)sprintf(pidSignature, "| grep -E '%s'", prgset->cont_pidc);
-			else
-				(void)sprintf(pidSignature, "| grep -v '^PID'");
-	#else
-			if (prgset->psigscan && strlen (prgset->cont_pidc))
-				(void)sprintf(pidSignature, "-TC %s", prgset->cont_pidc);
-			else if (strlen (prgset->cont_pidc))
-				(void)sprintf(pidSignature, "-C %s", prgset->cont_pidc);
-	#endif
+		default: // detect by pid signature
 			pidUpdate = getCmdLinePids;
-
-			pidSignature = realloc(pidSignature, strlen(pidSignature)+1);
 			break;
 	}
 }
@@ -675,7 +2064,7 @@ void *
 thread_update (void *arg)
 {
 	int32_t* pthread_state = (int32_t *)arg;
-	int cc = 0, ret, stop = 0, dlink_on = 0;
+	int cc = 0, sc = 0, ret, stop = 0, dlink_on = 0;
 	struct timespec intervaltv, now, old;
 
 	// get clock, use it as a future reference for update time TIMER_ABS*
@@ -720,8 +2109,19 @@ thread_update (void *arg)
 							" (obsolete kernel value) -- ");
 			}
 
-			// start docker link thread
-			dlink_on = (0 == startDockerThread());
+			// start docker link thread, not for offline replay
+			dlink_on = (!prgset->trace_play) && (0 == startDockerThread());
+
+			if (prgset->trace_rec)
+				openPidRecord();
+
+			// new PIDs on process events, not for offline replay
+			if (prgset->procevents && !prgset->trace_play)
+				(void)openProcEvents();
+
+			// exits of managed PIDs on pidfds, not for offline replay
+			if ((pidfdon = !prgset->trace_play))
+				initPidWatches();
 
 			// set local variable -- all CPUs set.
 			*pthread_state=1;
@@ -732,6 +2132,9 @@ thread_update (void *arg)
 				updateDocker();
 			if (cc)
 				break;
+			// with process events and all PIDs watched, full scan as fallback only
+			if (0 <= procfd && (pidfdon) && !pidfdmiss && (sc++ % PIDFD_SCANS))
+				break;
 			// update, once every td
 			scanNew();
 
@@ -760,6 +2163,12 @@ thread_update (void *arg)
 			if (dlink_on)
 				if (stopDockerThread())
 					warn("Unable to stop the Docker link thread");
+			closePidRecord();
+			freeReplayPids();
+			closeProcEvents();
+			freeContPids();
+			freePidWatches();
+			freeScanStrs();
 			//no break
 
 		case -99:
@@ -773,6 +2182,10 @@ thread_update (void *arg)
 
 		// If not, which timer?
 		if (SCHED_DEADLINE == prgset->policy){
+			// process events and exits of this period
+			if (0 <= procfd || (pidfdcnt))
+				(void)pollEvents(&(struct timespec){ 0 });
+
 			// perfect sync with period here, allow replenish 
 			if (pthread_yield()){
 				warn("pthread_yield() failed. errno: %s",strerror (ret));
@@ -789,9 +2202,10 @@ thread_update (void *arg)
 			intervaltv.tv_nsec+= (prgset->interval % USEC_PER_SEC) * 1000;
 			tsnorm(&intervaltv);
 
-			// sleep for interval nanoseconds
-			ret = clock_nanosleep(clocksources[prgset->clocksel], TIMER_ABSTIME, &intervaltv, NULL);
-			if (0 != ret) {
+			// sleep for interval nanoseconds, or handle process events meanwhile
+			if (0 <= procfd || (pidfdcnt))
+				waitEvents(&intervaltv);
+			else if (0 != (ret = clock_nanosleep(clocksources[prgset->clocksel], TIMER_ABSTIME, &intervaltv, NULL))) {
 				// Set warning only.. shouldn't stop working
 				// probably overrun, restarts immediately in attempt to catch up
 				if (EINTR != ret) {
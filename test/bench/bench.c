@@ -0,0 +1,110 @@
+/* 
+###############################
+# benchmark runner main script by Florian Hofer
+# last change: 17/10/2026
+# ©2026 all rights reserved ☺
+###############################
+*/
+#include "bench.h"
+
+// ############################ common global variables ###########################333
+
+// debug output file
+FILE  * dbg_out;
+FILE  * stats_out;
+
+containers_t * contparm; // container parameter settings
+prgset_t * prgset; // program settings structure
+
+// mutex to avoid read while updater fills or empties existing threads
+pthread_mutex_t dataMutex;
+
+// local head of PID list - PID runtime and configuration details
+node_t * nhead = NULL;
+
+// mutex to avoid read while updater fills or empties existing threads
+pthread_mutex_t resMutex; // UNUSED for now
+// heads of resource allocations for CPU and Tasks
+resTracer_t * rHead = NULL;
+
+// ############################ end common global variables ###########################333
+
+#include "manageBench.h"
+#include "updateBench.h"
+#include "dockerlinkBench.h"
+
+#include <stdlib.h>
+
+const int bench_nodes[] = { 16, 64, 256, 1024, 4096, 0 };
+
+/// bench_report(): print one result line, ns per event and events per second
+///
+/// Arguments: - name of the measured item
+///			   - number of PID nodes in the list
+///			   - number of events processed
+///			   - total time elapsed in ns
+///
+/// Return value: -
+///
+void
+bench_report(const char * name, int nodes, uint64_t events, uint64_t ns){
+	if (!events || !ns)
+		return;
+	(void)printf("%-28s nodes=%5d events=%9lu ns/event=%9.1f events/s=%12.0f\n",
+			name, nodes, events, (double)ns/(double)events,
+			(double)events * (double)NSEC_PER_SEC / (double)ns);
+}
+
+/// bench_reportBytes(): print one result line, throughput in bytes and events
+///
+/// Arguments: - name of the measured item
+///			   - number of bytes processed
+///			   - number of events processed
+///			   - total time elapsed in ns
+///
+/// Return value: -
+///
+void
+bench_reportBytes(const char * name, uint64_t bytes, uint64_t events, uint64_t ns){
+	if (!ns)
+		return;
+	(void)printf("%-28s bytes=%10lu MB/s=%9.1f events/s=%12.0f\n",
+			name, bytes, (double)bytes * (double)NSEC_PER_SEC / (double)ns / 1e6,
+			(double)events * (double)NSEC_PER_SEC / (double)ns);
+}
+
+/// bench_reportLock(): print one result line, data lock use
+///
+/// Arguments: - name of the measured item
+///			   - number of events processed
+///			   - number of lock acquisitions
+///			   - total time the lock was held in ns
+///			   - total time waited for the lock in ns
+///
+/// Return value: -
+///
+void
+bench_reportLock(const char * name, uint64_t events, uint64_t locks, uint64_t hold, uint64_t wait){
+	if (!locks)
+		return;
+	(void)printf("%-28s locks=%10lu events/lock=%7.1f hold ns/lock=%9.1f wait ns/lock=%9.1f\n",
+			name, locks, (double)events/(double)locks,
+			(double)hold/(double)locks, (double)wait/(double)locks);
+}
+
+int main(void)
+{
+	// init pseudo-random tables, fixed seed for comparable runs
+	srand(1);
+
+	// discard debug and statistics output
+	dbg_out = fopen("/dev/null", "w");
+	stats_out = dbg_out;
+
+	orchestrator_manage_bench();
+	orchestrator_update_bench();
+	orchestrator_dockerlink_bench();
+
+	(void)fclose(dbg_out);
+	return 0;
+}
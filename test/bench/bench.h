@@ -0,0 +1,35 @@
+/*
+ * bench.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Florian Hofer
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include "../../src/orchestrator/orchestrator.h"
+#include "../../src/include/cmnutil.h"
+
+#include <time.h>
+
+// debug output file
+extern FILE  * dbg_out;
+extern FILE  * stats_out;
+
+// node counts used by the benchmarks scaling with the PID list
+extern const int bench_nodes[];
+
+/// bench_now(): monotonic time stamp in ns
+static inline uint64_t
+bench_now(){
+	struct timespec ts;
+	(void)clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * NSEC_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+void bench_report(const char * name, int nodes, uint64_t events, uint64_t ns);
+void bench_reportBytes(const char * name, uint64_t bytes, uint64_t events, uint64_t ns);
+void bench_reportLock(const char * name, uint64_t events, uint64_t locks, uint64_t hold, uint64_t wait);
+
+#endif /* _BENCH_H_ */
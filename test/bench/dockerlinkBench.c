@@ -0,0 +1,156 @@
+/*
+###############################
+# benchmark script by Florian Hofer
+# last change: 17/10/2026
+# ©2026 all rights reserved ☺
+###############################
+*/
+
+#include "dockerlinkBench.h"
+#include "bench.h"
+
+// measured
+#include "../../src/lib/dockerlink.c"
+
+// former event parser
+#include <json-c/json.h>
+#include "../../src/include/parse_func.h"
+
+#define BENCH_ROUNDS	20000		// repetitions of the recorded event stream
+#define BENCH_BLOCK		JSON_FILE_BUF_SIZE	// bytes per read from the stream
+
+// recorded event stream, a container start-stop cycle
+static const char * bench_events[] = {
+	"{\"status\":\"create\",\"id\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"from\":\"testcnt\",\"Type\":\"container\",\"Action\":\"create\",\"Actor\":{\"ID\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"Attributes\":{\"image\":\"testcnt\",\"it.florianhofer.release-date\":\"2019-04-12\",\"it.florianhofer.version\":\"0.2.0\",\"it.florianhofer.version.is-production\":\"no\",\"name\":\"rt-app-tst-10\",\"vendor1\":\"Florian Hofer\",\"vendor2\":\"Florian Hofer\"}},\"scope\":\"local\",\"time\":1563572500,\"timeNano\":1563572500862449913}",
+	"{\"Type\":\"network\",\"Action\":\"connect\",\"Actor\":{\"ID\":\"a1ff03da79394dc71ea4b121f15ebfe58554f414a4ef4cedf8a54df4712b43d5\",\"Attributes\":{\"container\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"name\":\"bridge\",\"type\":\"bridge\"}},\"scope\":\"local\",\"time\":1563572500,\"timeNano\":1563572500962449913}",
+	"{\"status\":\"start\",\"id\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"from\":\"testcnt\",\"Type\":\"container\",\"Action\":\"start\",\"Actor\":{\"ID\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"Attributes\":{\"image\":\"testcnt\",\"it.florianhofer.release-date\":\"2019-04-12\",\"it.florianhofer.version\":\"0.2.0\",\"it.florianhofer.version.is-production\":\"no\",\"name\":\"rt-app-tst-10\",\"vendor1\":\"Florian Hofer\",\"vendor2\":\"Florian Hofer\"}},\"scope\":\"local\",\"time\":1563572501,\"timeNano\":1563572501557282644}",
+	"{\"status\":\"kill\",\"id\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"from\":\"testcnt\",\"Type\":\"container\",\"Action\":\"kill\",\"Actor\":{\"ID\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"Attributes\":{\"image\":\"testcnt\",\"it.florianhofer.release-date\":\"2019-04-12\",\"it.florianhofer.version\":\"0.2.0\",\"it.florianhofer.version.is-production\":\"no\",\"name\":\"rt-app-tst-10\",\"signal\":\"15\",\"vendor1\":\"Florian Hofer\",\"vendor2\":\"Florian Hofer\"}},\"scope\":\"local\",\"time\":1563572505,\"timeNano\":1563572505142834428}",
+	"{\"status\":\"die\",\"id\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"from\":\"testcnt\",\"Type\":\"container\",\"Action\":\"die\",\"Actor\":{\"ID\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"Attributes\":{\"exitCode\":\"0\",\"image\":\"testcnt\",\"it.florianhofer.release-date\":\"2019-04-12\",\"it.florianhofer.version\":\"0.2.0\",\"it.florianhofer.version.is-production\":\"no\",\"name\":\"rt-app-tst-10\",\"vendor1\":\"Florian Hofer\",\"vendor2\":\"Florian Hofer\"}},\"scope\":\"local\",\"time\":1563572505,\"timeNano\":1563572505313179855}",
+	"{\"Type\":\"network\",\"Action\":\"disconnect\",\"Actor\":{\"ID\":\"a1ff03da79394dc71ea4b121f15ebfe58554f414a4ef4cedf8a54df4712b43d5\",\"Attributes\":{\"container\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"name\":\"bridge\",\"type\":\"bridge\"}},\"scope\":\"local\",\"time\":1563572505,\"timeNano\":1563572505458969571}",
+	NULL
+};
+
+/// dockerlinkBench_free(): release strings of a container event
+static void
+dockerlinkBench_free(contevent_t * cntevent){
+	free(cntevent->name);
+	free(cntevent->id);
+	free(cntevent->image);
+}
+
+/// dockerlinkBench_json(): former parser, json-c object tree per event line
+///
+/// Arguments: - event stream, one event per line
+///
+/// Return value: number of container events found
+///
+static uint64_t
+dockerlinkBench_json(char * stream){
+	uint64_t found = 0;
+	char * line, * line_ptr;
+
+	for (line = strtok_r(stream, "\n", &line_ptr); line; line = strtok_r(NULL, "\n", &line_ptr)){
+		struct json_object * root = json_tokener_parse(line);
+		if (!root)
+			err_exit("Invalid JSON in bench stream");
+
+		char * type = get_string_value_from(root, "Type", FALSE, NULL);
+		char * status = NULL, * id = NULL, * from = NULL, * name = NULL;
+		if (!strcmp(type, "container")) {
+			status = get_string_value_from(root, "status", FALSE, NULL);
+			id = get_string_value_from(root, "id", FALSE, NULL);
+			from = get_string_value_from(root, "from", FALSE, NULL);
+			struct json_object * actor = get_in_object(root, "Actor", TRUE), * attrib;
+			if (actor && (attrib = get_in_object(actor, "Attributes", TRUE)))
+				name = get_string_value_from(attrib, "name", FALSE, NULL);
+		}
+		char * scope = get_string_value_from(root, "scope", FALSE, NULL);
+		uint64_t timenano = get_int64_value_from(root, "timeNano", FALSE, 0);
+		(void)json_object_put(root);
+
+		if (status && (!strcmp(status, "kill") || !strcmp(status, "create")
+				|| !strcmp(status, "start"))) {
+			contevent_t cntevent = { cnt_add, strdup(name), strdup(id), strdup(from), timenano };
+			found += (cntevent.timenano != 0);
+			dockerlinkBench_free(&cntevent);
+		}
+		free(type);
+		free(status);
+		free(name);
+		free(id);
+		free(from);
+		free(scope);
+	}
+	return found;
+}
+
+/// dockerlinkBench_tok(): streaming tokener, fixed blocks as read from the socket
+///
+/// Arguments: - event stream
+///			   - length of the stream
+///
+/// Return value: number of container events found
+///
+static uint64_t
+dockerlinkBench_tok(const char * stream, size_t len){
+	uint64_t found = 0;
+	contevent_t cntevent;
+
+	memset(&dtok, 0, sizeof(dtok));
+	for (size_t pos = 0; pos < len; ){
+		size_t cnt = MIN(BENCH_BLOCK, len - pos);
+
+		// consume the block, possibly several events
+		while (cnt) {
+			size_t used;
+			int ret = tok_feed(&dtok, stream + pos, cnt, &used);
+			if (0 > ret || (ret && tok_check(&dtok.evnt)))
+				err_exit("Invalid JSON in bench stream");
+			pos += used;
+			cnt -= used;
+			if (ret && make_event(&dtok.evnt, &cntevent)) {
+				found += (cntevent.timenano != 0);
+				dockerlinkBench_free(&cntevent);
+			}
+		}
+	}
+	return found;
+}
+
+/// orchestrator_dockerlink_bench(): container event parsing throughput
+void
+orchestrator_dockerlink_bench(){
+	size_t evlen = 0, len = 0;
+	int events = 0;
+
+	for (const char ** ev = bench_events; *ev; ev++, events++)
+		evlen += strlen(*ev) + 1;
+
+	// build the stream, one event per line as from CLI and API
+	char * stream = malloc(evlen * BENCH_ROUNDS + 1);
+	if (!stream)
+		err_exit("Could not allocate memory!");
+	for (int i = 0; i < BENCH_ROUNDS; i++)
+		for (const char ** ev = bench_events; *ev; ev++) {
+			size_t l = strlen(*ev);
+			(void)memcpy(stream + len, *ev, l);
+			len += l;
+			stream[len++] = '\n';
+		}
+	stream[len] = '\0';
+
+	uint64_t total = (uint64_t)events * BENCH_ROUNDS;
+	(void)printf("\n--- dockerlink: event parsing, json-c tree against streaming tokener ---\n");
+
+	// tokener first, the json-c path splits the stream in place
+	uint64_t start = bench_now();
+	uint64_t found = dockerlinkBench_tok(stream, len);
+	bench_reportBytes("dlink tokener", len, total, bench_now() - start);
+
+	start = bench_now();
+	if (found != dockerlinkBench_json(stream))
+		warn("Parsers disagree on container events");
+	bench_reportBytes("dlink json-c", len, total, bench_now() - start);
+
+	free(stream);
+}
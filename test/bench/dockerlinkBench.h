@@ -0,0 +1,13 @@
+/*
+ * dockerlinkBench.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Florian Hofer
+ */
+
+#ifndef TEST_DOCKERLINKBENCH_H_
+#define TEST_DOCKERLINKBENCH_H_
+
+void orchestrator_dockerlink_bench();
+
+#endif /* TEST_DOCKERLINKBENCH_H_ */
@@ -0,0 +1,554 @@
+/*
+###############################
+# benchmark script by Florian Hofer
+# last change: 17/10/2026
+# ©2026 all rights reserved ☺
+###############################
+*/
+
+#include "manageBench.h"
+#include "bench.h"
+
+// Includes from orchestrator library
+#include "../../src/include/parse_config.h"
+#include "../../src/include/kernutil.h"
+
+#include <pthread.h>
+
+// data lock use of the decode path, see bench_lock()
+static int bench_lock(pthread_mutex_t * m);
+static int bench_unlock(pthread_mutex_t * m);
+#define pthread_mutex_lock bench_lock
+#define pthread_mutex_unlock bench_unlock
+
+// measured
+#include "../../src/orchestrator/manage.c"
+
+#undef pthread_mutex_lock
+#undef pthread_mutex_unlock
+
+#include <sys/stat.h>
+
+#define BENCH_LOOKUPS	1000000		// lookups per node count
+#define BENCH_EVENTS	1000000		// events per node count
+#define BENCH_CPU		1			// CPU number of the simulated fTrace thread
+#define BENCH_PAGES		4096		// ring-buffer pages for ingestion
+#define BENCH_PAGEFILE	"test/resources/manage_ftread.dat"	// dump of a kernel trace page
+#define BENCH_DPAGES	1024		// synthetic ring-buffer pages per CPU
+#define BENCH_DELTA		1000		// time delta between synthetic events, ns
+#define BENCH_FMTFILE	"test/resources/manage_sched_%s_fmt%s.txt"	// kernel event formats
+#define BENCH_SWITCHID	316			// event IDs of the synthetic pages
+#define BENCH_WAKEUPID	318
+
+// decode path configurations, varied one at a time from the defaults
+static const char * const bench_fmts[][2] = { { "6.5", "6.5" }, { "6.1", "6.1" }, { NULL, NULL } };	// 6.5w is a malformed test case
+static const int bench_cpus[] = { 1, 2, 4, 0 };
+static const int bench_mix[] = { 100, 75, 50, -1 };	// percent of sched_switch events
+#define BENCH_DNODES	256			// default node count for decode runs
+static int bench_offsets = 0;		// force parsed offsets instead of packed views
+
+// Default struct common/switch/wakeup  - kernel 6.5
+static const struct tr_common bc_common = { (void *)0, (void *)2, (void *)3, (void *)4 };
+static const struct tr_switch bc_switch = { (void *)0x8, (void *)0x18, (void *)0x1C, (void *)0x20, (void*)0x28, (void*)0x38, (void*)0x3C };
+static const struct tr_wakeup bc_wakeup = { (void *)0x8, (void *)0x18, (void *)0x1C, (void *)0x20 };
+
+/// manageBench_setup(): create PID list with the given number of nodes
+///
+/// Arguments: - number of nodes to create, PIDs are 1..n*3 step 3
+///
+/// Return value: -
+///
+static void
+manageBench_setup(int nodes){
+	// push in ascending order -> list is descending, as in scanNew
+	for (int i = 1; i <= nodes; i++) {
+		node_push(&nhead);
+		nhead->pid = i * 3;
+		nhead->psig = strdup("bench");
+		nhead->attr.sched_policy = SCHED_FIFO;
+		nhead->attr.sched_priority = 10;
+		nhead->mon.assigned = BENCH_CPU;	// no CPU change, no re-computation
+		node_idxAdd(nhead);
+	}
+}
+
+static void
+manageBench_teardown(){
+	while (nhead)
+		node_pop(&nhead);
+	node_idxFree();
+}
+
+/// manageBench_listGet(): reference lookup, linear walk of the PID list
+static node_t *
+manageBench_listGet(pid_t pid){
+	for (node_t * item = nhead; ((item)); item=item->next )
+		if (item->pid == pid)
+			return item;
+	return NULL;
+}
+
+/// manageBench_lookup(): compare index and list walk PID lookup
+static void
+manageBench_lookup(int nodes){
+	pid_t * pids = malloc(sizeof(pid_t) * BENCH_LOOKUPS);
+	for (int i = 0; i < BENCH_LOOKUPS; i++)
+		// ~1/3 hits, rest are PIDs we do not track (system, other tasks)
+		pids[i] = rand() % (nodes * 3) + 1;
+
+	volatile uintptr_t sink = 0;
+	uint64_t start = bench_now();
+	for (int i = 0; i < BENCH_LOOKUPS; i++)
+		sink += (uintptr_t)node_idxGet(pids[i]);
+	bench_report("lookup index", nodes, BENCH_LOOKUPS, bench_now() - start);
+
+	// list walk is slow, use a reduced set
+	int cnt = BENCH_LOOKUPS/10;
+	start = bench_now();
+	for (int i = 0; i < cnt; i++)
+		sink += (uintptr_t)manageBench_listGet(pids[i]);
+	bench_report("lookup list walk", nodes, cnt, bench_now() - start);
+
+	(void)sink;
+	free(pids);
+}
+
+/// manageBench_events(): run synthetic sched_switch and sched_wakeup
+///						frames through the event handlers
+static void
+manageBench_events(int nodes){
+	struct ftrace_thread fthread = { NULL, 0, 0, BENCH_CPU, NULL };
+
+	tr_common = bc_common;
+	tr_switch = bc_switch;
+	tr_wakeup = bc_wakeup;
+
+	unsigned char frame [64] = {0x00,0x00,0x00,0x00,0x02,0x00,0x00,0x00 };
+	memcpy(&frame[0x8], "bench", 6);					// prev_comm
+	memcpy(&frame[0x28], "bench", 6);					// next_comm
+	*(int32_t*)&frame[0x3C] = 10;						// next_prio, not migration
+
+	uint64_t start = bench_now();
+	uint64_t ts = 1;
+	for (int i = 0; i < BENCH_EVENTS; i++) {
+		*(pid_t*)&frame[0x4] = rand() % (nodes * 3) + 1;
+		*(pid_t*)&frame[0x18] = *(pid_t*)&frame[0x4];
+		*(pid_t*)&frame[0x38] = rand() % (nodes * 3) + 1;
+		(void)pthread_mutex_lock(&dataMutex);
+		(void)pickPidInfoS_u(frame, &fthread, ts+=1000);
+		(void)pthread_mutex_unlock(&dataMutex);
+	}
+	bench_report("pickPidInfoS", nodes, BENCH_EVENTS, bench_now() - start);
+
+	start = bench_now();
+	for (int i = 0; i < BENCH_EVENTS; i++) {
+		*(pid_t*)&frame[0x4] = rand() % (nodes * 3) + 1;
+		*(pid_t*)&frame[0x18] = rand() % (nodes * 3) + 1;
+		(void)pthread_mutex_lock(&dataMutex);
+		(void)pickPidInfoW_u(frame, &fthread, ts+=1000);
+		(void)pthread_mutex_unlock(&dataMutex);
+	}
+	bench_report("pickPidInfoW", nodes, BENCH_EVENTS, bench_now() - start);
+
+	// same sched_switch events, applied a page (batch) per lock
+	struct ftrace_bevent batch[EVENT_BATCH];
+	unsigned char (* frames)[64] = malloc(sizeof(frame) * EVENT_BATCH);
+	for (int i = 0; i < EVENT_BATCH; i++) {
+		memcpy(frames[i], frame, sizeof(frame));
+		batch[i].eventcall = pickPidInfoS_u;
+		batch[i].addr = frames[i];
+	}
+
+	const int batches = BENCH_EVENTS / EVENT_BATCH;
+	start = bench_now();
+	for (int i = 0; i < batches; i++) {
+		for (int j = 0; j < EVENT_BATCH; j++) {
+			*(pid_t*)&frames[j][0x4] = rand() % (nodes * 3) + 1;
+			*(pid_t*)&frames[j][0x18] = *(pid_t*)&frames[j][0x4];
+			*(pid_t*)&frames[j][0x38] = rand() % (nodes * 3) + 1;
+			batch[j].ts = ts+=1000;
+		}
+		(void)applyEventBatch(batch, EVENT_BATCH, &fthread);
+	}
+	bench_report("pickPidInfoS page batch", nodes, batches * EVENT_BATCH, bench_now() - start);
+	free(frames);
+}
+
+/// manageBench_ingest(): compare page ingestion, read() copy vs mapped pages
+static void
+manageBench_ingest(){
+	unsigned char page[PIPE_BUFFER];
+	struct ftrace_thread fthread = { NULL, 0, 0, BENCH_CPU, NULL };
+	char fn[] = "/tmp/orchbench_XXXXXX";
+	FILE * f;
+
+	if (!(f = fopen(BENCH_PAGEFILE, "r")) || PIPE_BUFFER != fread(page, 1, PIPE_BUFFER, f)){
+		warn("Can not read %s, skipping ingestion benchmark", BENCH_PAGEFILE);
+		if (f)
+			(void)fclose(f);
+		return;
+	}
+	(void)fclose(f);
+
+	// count events of page and register handler for its switch events
+	struct kbuffer * kbuf = kbuffer_alloc(KBUFFER_LSIZE_SAME_AS_HOST, KBUFFER_ENDIAN_SAME_AS_HOST);
+	uint64_t events = 0;
+	(void)kbuffer_load_subbuffer(kbuf, page);
+	for (void * pEvent = kbuffer_read_event(kbuf, NULL); (pEvent); pEvent = kbuffer_next_event(kbuf, NULL)){
+		if (!events)
+			(void)setEventCall(*(uint16_t*)pEvent, pickPidInfoS_u);
+		events++;
+	}
+	events *= BENCH_PAGES;
+
+	tr_common = bc_common;
+	tr_switch = bc_switch;
+
+	int fd = mkstemp(fn);
+	if (0 > fd){
+		warn("Can not create page file, skipping ingestion benchmark");
+		kbuffer_free(kbuf);
+		return;
+	}
+	(void)unlink(fn);
+	for (int i = 0; i < BENCH_PAGES; i++)
+		if (PIPE_BUFFER != write(fd, page, PIPE_BUFFER))
+			break;
+
+	// copy path, read() into stack buffer
+	uint64_t start = bench_now();
+	(void)lseek(fd, 0, SEEK_SET);
+	while (PIPE_BUFFER == read(fd, page, PIPE_BUFFER))
+		(void)parsePage(kbuf, page, &fthread);
+	bench_reportBytes("ingest read()", (uint64_t)BENCH_PAGES * PIPE_BUFFER, events, bench_now() - start);
+
+	// zero-copy path, parse pages in place
+	unsigned char * data = mmap(NULL, (size_t)BENCH_PAGES * PIPE_BUFFER, PROT_READ, MAP_SHARED, fd, 0);
+	if (MAP_FAILED != data){
+		start = bench_now();
+		for (int i = 0; i < BENCH_PAGES; i++)
+			(void)parsePage(kbuf, data + (size_t)i * PIPE_BUFFER, &fthread);
+		bench_reportBytes("ingest mapped", (uint64_t)BENCH_PAGES * PIPE_BUFFER, events, bench_now() - start);
+		(void)munmap(data, (size_t)BENCH_PAGES * PIPE_BUFFER);
+	}
+
+	(void)close(fd);
+	kbuffer_free(kbuf);
+	free(elist_disp);
+	elist_disp = NULL;
+	elist_dispsz = 0;
+}
+
+// per thread lock statistics of dataMutex
+static __thread uint64_t bench_lkcnt;	// acquisitions
+static __thread uint64_t bench_lkhold;	// total hold time, ns
+static __thread uint64_t bench_lkwait;	// total wait time, ns
+static __thread uint64_t bench_lkts;	// time-stamp of last acquisition
+
+/// bench_lock(): lock a mutex, account wait time for dataMutex
+static int
+bench_lock(pthread_mutex_t * m){
+	if (m != &dataMutex)
+		return pthread_mutex_lock(m);
+
+	uint64_t start = bench_now();
+	int ret = pthread_mutex_lock(m);
+	bench_lkts = bench_now();
+	bench_lkwait += bench_lkts - start;
+	bench_lkcnt++;
+	return ret;
+}
+
+/// bench_unlock(): unlock a mutex, account hold time for dataMutex
+static int
+bench_unlock(pthread_mutex_t * m){
+	if (m == &dataMutex)
+		bench_lkhold += bench_now() - bench_lkts;
+	return pthread_mutex_unlock(m);
+}
+
+// synthetic CPU ring-buffer and its decoding thread
+struct bench_decode {
+	pthread_t thread;
+	struct ftrace_thread fthread;
+	unsigned char * pages;
+	int npages;
+	uint64_t events;
+	uint64_t locks, hold, wait;
+};
+
+/// manageBench_loadFormats(): register sched_switch and wakeup with formats
+///						of the given kernel versions and parse offsets
+///
+/// Arguments: - sched_switch and sched_wakeup format version
+///
+/// Return value: 0 on success, -1 if the format is not usable
+///
+static int
+manageBench_loadFormats(const char * const fmt[2]){
+	const char * const events[2] = { "switch", "wakeup" };
+	const int ids[2] = { BENCH_SWITCHID, BENCH_WAKEUPID };
+	const ftrace_call_t calls[2] = { pickPidInfoS_u, pickPidInfoW_u };
+
+	for (int i = 0; i < 2; i++){
+		char fn[_POSIX_PATH_MAX];
+		char buf[PIPE_BUFFER];
+		size_t len = 0;
+
+		(void)sprintf(fn, BENCH_FMTFILE, events[i], fmt[i]);
+		FILE * f = fopen(fn, "r");
+		if (f){
+			len = fread(buf, 1, sizeof(buf)-1, f);
+			(void)fclose(f);
+		}
+		if (!len){
+			warn("Can not read %s", fn);
+			return -1;
+		}
+		buf[len] = '\0';
+
+		if (addEvent((i) ? TR_EVENT_WAKEUP : TR_EVENT_SWITCH, ids[i], calls[i], NULL, buf))
+			return -1;
+	}
+	return parseEventOffsets();
+}
+
+/// manageBench_clearFormats(): drop registered events
+static void
+manageBench_clearFormats(){
+	while (elist_head){
+		free(elist_head->event);
+		while (elist_head->fields){
+			free(elist_head->fields->name);
+			pop((void**)&elist_head->fields);
+		}
+		pop((void**)&elist_head);
+	}
+	free(elist_disp);
+	elist_disp = NULL;
+	elist_dispsz = 0;
+}
+
+/// manageBench_setField(): write a value to an event field, host byte order
+static void
+manageBench_setField(const struct ftrace_elist * event, unsigned char * frame,
+		const char * name, const void * value, size_t size){
+	for (const struct ftrace_ecfg * field = event->fields; (field); field=field->next)
+		if (!strcmp(field->name, name)){
+			memcpy(frame + field->offset, value, MIN((size_t)field->size, size));
+			return;
+		}
+}
+
+/// manageBench_eventSize(): payload size of an event, 4 byte aligned
+static size_t
+manageBench_eventSize(const struct ftrace_elist * event){
+	size_t size = 0;
+	for (const struct ftrace_ecfg * field = event->fields; (field); field=field->next)
+		size = MAX(size, (size_t)(field->offset + field->size));
+	return (size + 3) & ~3;
+}
+
+/// manageBench_pid(): random PID, tracked ones run on the given CPU
+static pid_t
+manageBench_pid(int nodes, int cpus, int cpu){
+	pid_t pid = rand() % (nodes * 3) + 1;
+	return pid - pid % cpus + cpu;
+}
+
+/// manageBench_genPage(): fill a ring-buffer page with synthetic sched events
+///
+/// Arguments: - page buffer, PIPE_BUFFER
+///			   - time stamp of the page
+///			   - number of nodes, CPU count and CPU of page
+///			   - percentage of sched_switch events, rest is sched_wakeup
+///
+/// Return value: number of events in the page
+///
+static int
+manageBench_genPage(unsigned char * page, uint64_t ts, int nodes, int cpus, int cpu, int mix){
+	const struct ftrace_elist * evsw = NULL, * evwk = NULL;
+	for (const struct ftrace_elist * event = elist_head; (event); event=event->next)
+		if (BENCH_SWITCHID == event->eventid)
+			evsw = event;
+		else
+			evwk = event;
+
+	const size_t szsw = manageBench_eventSize(evsw);
+	const size_t szwk = manageBench_eventSize(evwk);
+	const int32_t prio = 10;	// not migration, next_prio = 0
+	const uint64_t state = 0;
+	size_t pos = 16;			// header: time stamp, commit
+	int cnt = 0;
+
+	(void)memset(page, 0, PIPE_BUFFER);
+	*(uint64_t *)page = ts;
+
+	for (;;) {
+		const int isSwitch = (rand() % 100 < mix);
+		const struct ftrace_elist * event = (isSwitch) ? evsw : evwk;
+		const size_t size = (isSwitch) ? szsw : szwk;
+		if (pos + 4 + size > PIPE_BUFFER)
+			break;
+
+		// event header, data length in words and time delta
+		*(uint32_t *)(page + pos) = (uint32_t)(size / 4) | (BENCH_DELTA << 5);
+		unsigned char * frame = page + pos + 4;
+
+		const uint16_t type = event->eventid;
+		pid_t pid = manageBench_pid(nodes, cpus, cpu);
+		manageBench_setField(event, frame, "common_type", &type, sizeof(type));
+		manageBench_setField(event, frame, "common_pid", &pid, sizeof(pid));
+
+		if (isSwitch){
+			pid_t next = manageBench_pid(nodes, cpus, cpu);
+			manageBench_setField(event, frame, "prev_comm", "bench", 6);
+			manageBench_setField(event, frame, "prev_pid", &pid, sizeof(pid));
+			manageBench_setField(event, frame, "prev_prio", &prio, sizeof(prio));
+			manageBench_setField(event, frame, "prev_state", &state, sizeof(state));
+			manageBench_setField(event, frame, "next_comm", "bench", 6);
+			manageBench_setField(event, frame, "next_pid", &next, sizeof(next));
+			manageBench_setField(event, frame, "next_prio", &prio, sizeof(prio));
+		}
+		else{
+			manageBench_setField(event, frame, "comm", "bench", 6);
+			manageBench_setField(event, frame, "pid", &pid, sizeof(pid));
+			manageBench_setField(event, frame, "prio", &prio, sizeof(prio));
+			manageBench_setField(event, frame, "target_cpu", &cpu, sizeof(cpu));
+		}
+
+		pos += 4 + size;
+		cnt++;
+	}
+
+	*(uint64_t *)(page + 8) = pos - 16;	// commit, bytes of data
+	return cnt;
+}
+
+/// manageBench_decodeThread(): decode and apply the pages of one CPU
+static void *
+manageBench_decodeThread(void * arg){
+	struct bench_decode * dec = arg;
+	struct kbuffer * kbuf = kbuffer_alloc(KBUFFER_LSIZE_SAME_AS_HOST, KBUFFER_ENDIAN_SAME_AS_HOST);
+
+	bench_lkcnt = bench_lkhold = bench_lkwait = 0;
+	for (int i = 0; i < dec->npages; i++)
+		(void)parsePage(kbuf, dec->pages + (size_t)i * PIPE_BUFFER, &dec->fthread);
+
+	dec->locks = bench_lkcnt;
+	dec->hold = bench_lkhold;
+	dec->wait = bench_lkwait;
+	kbuffer_free(kbuf);
+	return NULL;
+}
+
+/// manageBench_decode(): run synthetic pages through decoder and handlers,
+///						one thread per simulated CPU
+///
+/// Arguments: - sched_switch and sched_wakeup format version
+///			   - number of nodes in the PID list
+///			   - number of CPUs (reader threads)
+///			   - percentage of sched_switch events
+///
+/// Return value: -
+///
+static void
+manageBench_decode(const char * const fmt[2], int nodes, int cpus, int mix){
+	char name[64];
+	struct bench_decode dec[cpus];
+
+	if (manageBench_loadFormats(fmt)){
+		warn("Format %s/%s not usable, skipping", fmt[0], fmt[1]);
+		manageBench_clearFormats();
+		return;
+	}
+	if (bench_offsets)
+		tr_common_lay = tr_switch_lay = tr_wakeup_lay = trl_offset;
+
+	manageBench_setup(nodes);
+	for (node_t * item = nhead; ((item)); item=item->next)
+		item->mon.assigned = item->pid % cpus;	// no migration
+
+	for (int c = 0; c < cpus; c++){
+		dec[c].fthread = (struct ftrace_thread){ NULL, 0, 0, c, NULL, 0 };
+		dec[c].npages = BENCH_DPAGES;
+		dec[c].events = 0;
+		if (!(dec[c].pages = malloc((size_t)BENCH_DPAGES * PIPE_BUFFER)))
+			err_exit("could not allocate memory!");
+		uint64_t ts = NSEC_PER_SEC;
+		for (int i = 0; i < BENCH_DPAGES; i++){
+			int cnt = manageBench_genPage(dec[c].pages + (size_t)i * PIPE_BUFFER, ts, nodes, cpus, c, mix);
+			dec[c].events += cnt;
+			ts += (uint64_t)cnt * BENCH_DELTA;
+		}
+	}
+
+	uint64_t start = bench_now();
+	for (int c = 0; c < cpus; c++)
+		if (pthread_create(&dec[c].thread, NULL, manageBench_decodeThread, &dec[c]))
+			err_exit("could not start decode thread");
+	uint64_t events = 0, locks = 0, hold = 0, wait = 0;
+	for (int c = 0; c < cpus; c++){
+		(void)pthread_join(dec[c].thread, NULL);
+		events += dec[c].events;
+		locks += dec[c].locks;
+		hold += dec[c].hold;
+		wait += dec[c].wait;
+		free(dec[c].pages);
+	}
+	uint64_t ns = bench_now() - start;
+
+	(void)snprintf(name, sizeof(name), "decode fmt%s%s cpus=%d sw=%d%%", fmt[0],
+			(trl_offset == tr_switch_lay) ? "/offs" : "", cpus, mix);
+	bench_report(name, nodes, events, ns);
+	bench_reportLock("", events, locks, hold, wait);
+
+	manageBench_teardown();
+	manageBench_clearFormats();
+}
+
+/// orchestrator_manage_bench(): event handler cost as the PID list grows
+void
+orchestrator_manage_bench(){
+	prgset = calloc (1, sizeof(prgset_t));
+	parse_config_set_default(prgset);
+	prgset->sched_mode = SM_STATIC;	// no re-allocation, measure handlers only
+
+	(void)printf("\n--- manage: PID lookup and event handler cost ---\n");
+	for (const int * nodes = bench_nodes; *nodes; nodes++){
+		manageBench_setup(*nodes);
+		manageBench_lookup(*nodes);
+		manageBench_events(*nodes);
+		manageBench_teardown();
+	}
+
+	(void)printf("\n--- manage: trace page ingestion ---\n");
+	manageBench_setup(bench_nodes[2]);
+	manageBench_ingest();
+	manageBench_teardown();
+
+	(void)printf("\n--- manage: synthetic page decode, node count ---\n");
+	for (const int * nodes = bench_nodes; *nodes; nodes++)
+		manageBench_decode(bench_fmts[0], *nodes, bench_cpus[0], bench_mix[1]);
+
+	(void)printf("\n--- manage: synthetic page decode, event mix ---\n");
+	for (const int * mix = bench_mix; 0 <= *mix; mix++)
+		manageBench_decode(bench_fmts[0], BENCH_DNODES, bench_cpus[0], *mix);
+
+	(void)printf("\n--- manage: synthetic page decode, CPU count ---\n");
+	for (const int * cpus = bench_cpus; *cpus; cpus++)
+		manageBench_decode(bench_fmts[0], BENCH_DNODES, *cpus, bench_mix[1]);
+
+	(void)printf("\n--- manage: synthetic page decode, event format ---\n");
+	for (int i = 0; (bench_fmts[i][0]); i++)
+		manageBench_decode(bench_fmts[i], BENCH_DNODES, bench_cpus[0], bench_mix[1]);
+
+	(void)printf("\n--- manage: synthetic page decode, parsed offsets instead of views ---\n");
+	bench_offsets = 1;
+	for (int i = 0; (bench_fmts[i][0]); i++)
+		manageBench_decode(bench_fmts[i], BENCH_DNODES, bench_cpus[0], bench_mix[1]);
+	bench_offsets = 0;
+
+	freePrgSet(prgset);
+	prgset = NULL;
+}
@@ -0,0 +1,13 @@
+/*
+ * manageBench.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Florian Hofer
+ */
+
+#ifndef TEST_MANAGEBENCH_H_
+#define TEST_MANAGEBENCH_H_
+
+void orchestrator_manage_bench();
+
+#endif /* TEST_MANAGEBENCH_H_ */
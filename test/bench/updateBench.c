@@ -0,0 +1,176 @@
+/*
+###############################
+# benchmark script by Florian Hofer
+# last change: 17/10/2026
+# ©2026 all rights reserved ☺
+###############################
+*/
+
+#include "updateBench.h"
+#include "bench.h"
+
+// Includes from orchestrator library
+#include "../../src/include/parse_config.h"
+#include "../../src/include/kernutil.h"
+
+// measured
+#include "../../src/orchestrator/update.c"
+
+#include <limits.h>
+#include <sys/resource.h>
+
+#define BENCH_SCANS		20			// scans per thread count
+
+static const int bench_threads[] = { 1000, 10000, 0 };	// threads of the scanned process
+
+// idle threads of the benchmark process, scanned as container threads
+static pthread_mutex_t bench_tmutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t bench_tcond = PTHREAD_COND_INITIALIZER;
+static int bench_tstop;
+
+/// updateBench_idle(): idle thread, waits for stop
+static void *
+updateBench_idle(void * arg){
+	(void)pthread_mutex_lock(&bench_tmutex);
+	while (!bench_tstop)
+		(void)pthread_cond_wait(&bench_tcond, &bench_tmutex);
+	(void)pthread_mutex_unlock(&bench_tmutex);
+	return NULL;
+}
+
+/// updateBench_cpu(): CPU time used by this process and its waited-for children
+///
+/// Return value: user and system time in ns
+///
+static uint64_t
+updateBench_cpu(){
+	struct rusage self, child;
+	(void)getrusage(RUSAGE_SELF, &self);
+	(void)getrusage(RUSAGE_CHILDREN, &child);
+	return (uint64_t)(self.ru_utime.tv_sec + self.ru_stime.tv_sec
+			+ child.ru_utime.tv_sec + child.ru_stime.tv_sec) * NSEC_PER_SEC
+		+ (uint64_t)(self.ru_utime.tv_usec + self.ru_stime.tv_usec
+			+ child.ru_utime.tv_usec + child.ru_stime.tv_usec) * 1000;
+}
+
+/// updateBench_psPids(): former scan, threads of processes by name via 'ps'
+///
+/// Arguments: - pointer to linked list of PID
+///			   - process name
+///
+/// Return value: -
+///
+static void
+updateBench_psPids(node_t **pidlst, const char * tag){
+	char req[CMD_LEN];
+	char pidline[BUFRD];
+	char *pid, *pid_ptr;
+	FILE *fp;
+
+	(void)snprintf(req, sizeof(req), "ps h -o spid,command -TC %s", tag);
+	if(!(fp = popen(req,"r")))
+		return;
+
+	while(fgets(pidline,BUFRD,fp)) {
+		pid = strtok_r (pidline," ", &pid_ptr);
+		node_push(pidlst);
+		(*pidlst)->pid = atoi(pid);
+		pid = strtok_r (NULL, "\n", &pid_ptr);
+		if (!((*pidlst)->psig = strdup((pid) ? pid : "")))
+			err_exit("Could not allocate memory!");
+	}
+	pclose(fp);
+}
+
+/// updateBench_scan(): time repeated scans for the threads of this process
+///
+/// Arguments: - name of the scan method
+///			   - use /proc walker, else ps
+///			   - process name
+///			   - expected number of threads
+///
+/// Return value: -
+///
+static void
+updateBench_scan(const char * name, int native, const char * comm, int threads){
+	char line[64];
+	uint64_t found = 0;
+	uint64_t cpu = updateBench_cpu();
+	uint64_t start = bench_now();
+
+	for (int i = 0; i < BENCH_SCANS; i++){
+		node_t * lst = NULL;
+		if (native)
+			getPids(&lst, comm, NULL, 0, 1);
+		else
+			updateBench_psPids(&lst, comm);
+		while (lst){
+			found++;
+			if (native)	// strings borrowed from the scan table
+				popScanPid(&lst);
+			else
+				node_pop(&lst);
+		}
+		if (native)
+			sweepScanStrs();
+	}
+
+	uint64_t ns = bench_now() - start;
+	cpu = updateBench_cpu() - cpu;
+
+	if (found != (uint64_t)threads * BENCH_SCANS)
+		warn("%s found %lu of %d threads per scan", name, found / BENCH_SCANS, threads);
+
+	(void)snprintf(line, sizeof(line), "scan %s", name);
+	(void)printf("%-28s threads=%6d us/scan=%10.1f cpu us/scan=%10.1f\n",
+			line, threads, (double)ns / BENCH_SCANS / 1000.0,
+			(double)cpu / BENCH_SCANS / 1000.0);
+}
+
+/// orchestrator_update_bench(): PID scan latency and CPU cost, /proc against ps
+void
+orchestrator_update_bench(){
+	char comm[32];
+	int cnt = 1;	// main thread
+	pthread_attr_t attr;
+
+	prgset = calloc (1, sizeof(prgset_t));
+	parse_config_set_default(prgset);
+
+	if (0 >= getkernvar("/proc/self/", "comm", comm, sizeof(comm))){
+		warn("Can not read own process name, skipping");
+		goto out;
+	}
+
+	(void)pthread_attr_init(&attr);
+	(void)pthread_attr_setstacksize(&attr, PTHREAD_STACK_MIN);
+	bench_tstop = 0;
+
+	(void)printf("\n--- update: PID scan, /proc walker against ps ---\n");
+	for (const int * threads = bench_threads; *threads; threads++){
+		for (; cnt < *threads; cnt++){
+			pthread_t thread;
+			if (pthread_create(&thread, &attr, updateBench_idle, NULL))
+				break;
+			(void)pthread_detach(thread);
+		}
+		if (cnt < *threads){
+			warn("Thread limit reached at %d threads", cnt);
+			break;
+		}
+
+		updateBench_scan("/proc", 1, comm, cnt);
+		updateBench_scan("ps", 0, comm, cnt);
+	}
+
+	// release idle threads
+	(void)pthread_mutex_lock(&bench_tmutex);
+	bench_tstop = 1;
+	(void)pthread_cond_broadcast(&bench_tcond);
+	(void)pthread_mutex_unlock(&bench_tmutex);
+	(void)pthread_attr_destroy(&attr);
+
+out:
+	freePrgSet(prgset);
+	prgset = NULL;
+}
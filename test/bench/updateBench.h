@@ -0,0 +1,13 @@
+/*
+ * updateBench.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Florian Hofer
+ */
+
+#ifndef TEST_UPDATEBENCH_H_
+#define TEST_UPDATEBENCH_H_
+
+void orchestrator_update_bench();
+
+#endif /* TEST_UPDATEBENCH_H_ */
@@ -14,6 +14,9 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <signal.h> 		// for SIGs, handling in main, raise in update
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 static char * dockerlink_empty [6] = {
 	"",			// empty
@@ -43,42 +46,32 @@ static contevent_t cntexpected[6] = {
 	};
 
 static void checkContainer(contevent_t * cntevent) {
+	contevent_t evnt;
 
 	usleep(1000);
-	(void)pthread_mutex_lock(&containerMutex);
-			
-	while (!containerEvent) {
-		(void)pthread_mutex_unlock(&containerMutex);
-
+	while (!dlink_pop(&evnt, 1)) {
 		// if no event, and we did't expect one. return
-		if (!cntevent->id){
-			ck_assert(!containerEvent);
+		if (!cntevent->id)
 			return;
-		}
 
 		usleep(1000);
-		(void)pthread_mutex_lock(&containerMutex);
 	}
 
-	ck_assert(containerEvent);
-	ck_assert(containerEvent->name);
-	ck_assert(containerEvent->id);
-	ck_assert(containerEvent->image);
+	ck_assert(cntevent->id);
+	ck_assert(evnt.name);
+	ck_assert(evnt.id);
+	ck_assert(evnt.image);
 
-	ck_assert_int_eq(cntevent->event, containerEvent->event);
-	ck_assert_str_eq(cntevent->name, containerEvent->name);
-	ck_assert_str_eq(cntevent->id, containerEvent->id);
-	ck_assert_str_eq(cntevent->image, containerEvent->image);
-	ck_assert_int_eq(cntevent->timenano, containerEvent->timenano);
+	ck_assert_int_eq(cntevent->event, evnt.event);
+	ck_assert_str_eq(cntevent->name, evnt.name);
+	ck_assert_str_eq(cntevent->id, evnt.id);
+	ck_assert_str_eq(cntevent->image, evnt.image);
+	ck_assert_int_eq(cntevent->timenano, evnt.timenano);
 
 	// cleanup
-	free(containerEvent->name);
-	free(containerEvent->id);
-	free(containerEvent->image);
-	free(containerEvent);
-	containerEvent = NULL;
-	(void)pthread_mutex_unlock(&containerMutex);
-
+	free(evnt.name);
+	free(evnt.id);
+	free(evnt.image);
 }
 
 /// TEST CASE -> cycle through invalid JSON events
@@ -199,6 +192,292 @@ START_TEST(dockerlink_startfail)
 }
 END_TEST
 
+// Engine API stand-in, replays the recorded events over a unix socket
+static struct dlink_server {
+	pthread_t thread;
+	int fd;				// listening socket
+	char dir[32];		// temporary directory
+	char path[64];		// socket path
+	int code;			// HTTP status to reply with
+	size_t split;		// max bytes per chunk, 0 = one chunk per event
+	int request;		// events request received
+	char req[1024];		// last request received
+} dsrv;
+
+static void dockerlink_chunk(int fd, const char * data, size_t len) {
+	size_t cnt = (dsrv.split) ? dsrv.split : len;
+	for (; len; data += cnt, len -= cnt) {
+		if (cnt > len)
+			cnt = len;
+		(void)dprintf(fd, "%zx\r\n", cnt);
+		(void)!write(fd, data, cnt);
+		(void)!write(fd, "\r\n", 2);
+	}
+}
+
+static void * dockerlink_server(void * arg) {
+	char buf[1024] = "";
+	size_t len = 0;
+	ssize_t got;
+
+	int fd = accept(dsrv.fd, NULL, NULL);
+	if (0 > fd)
+		return NULL;
+
+	// request header
+	while (len < sizeof(buf)-1 && 0 < (got = read(fd, buf + len, sizeof(buf)-1-len))) {
+		len += got;
+		buf[len] = '\0';
+		if (strstr(buf, "\r\n\r\n"))
+			break;
+	}
+	dsrv.request = !strncmp(buf, "GET /events", 11);
+	(void)strcpy(dsrv.req, buf);
+
+	// container update, no stream
+	if (!strncmp(buf, "POST ", 5)) {
+		(void)dprintf(fd, "HTTP/1.1 %d %s\r\nContent-Length: 0\r\n\r\n",
+				dsrv.code, (200 == dsrv.code) ? "OK" : "Not Found");
+		(void)close(fd);
+		return NULL;
+	}
+
+	(void)dprintf(fd, "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n", dsrv.code, (200 == dsrv.code) ? "OK" : "Not Found");
+	if (200 == dsrv.code) {
+		for (int i=0; i<6; i++) {
+			dockerlink_chunk(fd, dockerlink_events[i], strlen(dockerlink_events[i]));
+			dockerlink_chunk(fd, "\n", 1);
+		}
+		(void)dprintf(fd, "0\r\n\r\n");
+	}
+	(void)close(fd);
+	return NULL;
+}
+
+static void dockerlink_api_setup() {
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+	memset(&dsrv, 0, sizeof(dsrv));
+	dsrv.code = 200;
+	(void)strcpy(dsrv.dir, "/tmp/dlinkXXXXXX");
+	ck_assert(mkdtemp(dsrv.dir));
+	(void)sprintf(dsrv.path, "unix://%s/docker.sock", dsrv.dir);
+	(void)strcpy(addr.sun_path, dsrv.path + 7);
+
+	dsrv.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	ck_assert_int_le(0, dsrv.fd);
+	ck_assert_int_eq(0, bind(dsrv.fd, (struct sockaddr *)&addr, sizeof(addr)));
+	ck_assert_int_eq(0, listen(dsrv.fd, 1));
+}
+
+static void dockerlink_api_teardown() {
+	(void)close(dsrv.fd);
+	(void)unlink(dsrv.path + 7);
+	(void)rmdir(dsrv.dir);
+}
+
+static const size_t dockerlink_splits [4] = { 0, 1, 7, 100 };
+
+static const char * dockerlink_create = "{\"status\":\"create\",\"id\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"from\":\"testcnt\",\"Type\":\"container\",\"Action\":\"create\",\"Actor\":{\"ID\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"Attributes\":{\"image\":\"testcnt\",\"name\":\"rt-app-tst-10\"}},\"scope\":\"local\",\"time\":1563572501,\"timeNano\":1563572501257282644}";
+
+/// TEST CASE -> replay event stream through Engine API stand-in
+/// EXPECTED -> container response for 0 and 5 only, independent of chunking
+/// NOTES -> thread exits when stream ends
+START_TEST(dockerlink_api)
+{
+	pthread_t thread1;
+	int  iret1;
+
+	dsrv.split = dockerlink_splits[_i];
+	ck_assert_int_eq(0, pthread_create(&dsrv.thread, NULL, dockerlink_server, NULL));
+
+	iret1 = pthread_create( &thread1, NULL, dlink_thread_watch, (void*) dsrv.path);
+	ck_assert_int_eq(iret1, 0);
+
+	checkContainer(&cntexpected[0]);
+	checkContainer(&cntexpected[5]);
+
+	if (!iret1) // thread started successfully
+		iret1 = pthread_join( thread1, NULL); // wait until end
+	(void)pthread_join(dsrv.thread, NULL);
+	ck_assert(dsrv.request);
+}
+END_TEST
+
+/// TEST CASE -> container create event
+/// EXPECTED -> create posted for pre-placement
+START_TEST(dockerlink_conf_create)
+{
+	pthread_t thread1;
+	int  iret1;
+	char buf[1024] = "echo '";
+	contevent_t expected = { cnt_create, "rt-app-tst-10", "4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29", "testcnt", 1563572501257282644};
+
+	strcat(strcat(buf, dockerlink_create), "'");
+	iret1 = pthread_create( &thread1, NULL, dlink_thread_watch, (void*) buf);
+	ck_assert_int_eq(iret1, 0);
+	checkContainer(&expected);
+	if (!iret1) // thread started successfully
+		iret1 = pthread_join( thread1, NULL ); // wait until end
+}
+END_TEST
+
+/// TEST CASE -> feed an event split at every position to the tokener
+/// EXPECTED -> same fields for all splits, nested and escaped keys ignored
+START_TEST(dockerlink_tok)
+{
+	const char * evnt = "{\"status\":\"kill\",\"id\":\"4cf50eb963ca\",\"from\":\"test\\\"cnt\","
+		"\"Type\":\"container\",\"Actor\":{\"ID\":\"4cf50eb963ca\",\"name\":\"no\","
+		"\"Attributes\":{\"list\":[{\"name\":\"no\"},1,null],\"name\":\"rt-app-tst-10\"}},"
+		"\"na\\u006de\":\"no\",\"scope\":\"local\",\"time\":1563572495,\"timeNano\":1563572495142834428}\n";
+	size_t len = strlen(evnt);
+
+	for (size_t split = 0; split <= len; split++) {
+		size_t used, used2;
+		memset(&dtok, 0, sizeof(dtok));
+
+		int ret = tok_feed(&dtok, evnt, split, &used);
+		if (!ret) {
+			ck_assert_int_eq(split, used);
+			ret = tok_feed(&dtok, evnt + split, len - split, &used2);
+			used += used2;
+		}
+		ck_assert_int_eq(1, ret);
+		ck_assert_int_eq(len - 1, used);	// newline left over
+		ck_assert_int_eq(0, tok_check(&dtok.evnt));
+
+		ck_assert_str_eq("container", dtok.evnt.type);
+		ck_assert_str_eq("kill", dtok.evnt.status);
+		ck_assert_str_eq("4cf50eb963ca", dtok.evnt.id);
+		ck_assert_str_eq("test\"cnt", dtok.evnt.from);
+		ck_assert_str_eq("rt-app-tst-10", dtok.evnt.name);
+		ck_assert(1563572495142834428 == dtok.evnt.timenano);
+	}
+
+	// syntax errors
+	size_t used;
+	memset(&dtok, 0, sizeof(dtok));
+	ck_assert_int_eq(-1, tok_feed(&dtok, "x{}", 3, &used));
+	memset(&dtok, 0, sizeof(dtok));
+	ck_assert_int_eq(-1, tok_feed(&dtok, "{\"a\":[}", 8, &used));
+}
+END_TEST
+
+/// TEST CASE -> update container CPU-set through Engine API stand-in
+/// EXPECTED -> request with CPU list, result depends on reply, CLI mode refused
+START_TEST(dockerlink_cpuset)
+{
+	// reading through CLI
+	ck_assert_int_eq(-1, dlink_cpuset("4cf50eb963ca", "2-3"));
+	ck_assert_int_eq(ENOTCONN, errno);
+
+	dlink_api = dsrv.path + 7;
+	dsrv.code = (_i) ? 404 : 200;
+	ck_assert_int_eq(0, pthread_create(&dsrv.thread, NULL, dockerlink_server, NULL));
+
+	ck_assert_int_eq((_i) ? -1 : 0, dlink_cpuset("4cf50eb963ca", "2-3"));
+	(void)pthread_join(dsrv.thread, NULL);
+	ck_assert(strstr(dsrv.req, "POST /containers/4cf50eb963ca/update HTTP/1.1\r\n"));
+	ck_assert(strstr(dsrv.req, "\r\n\r\n{\"CpusetCpus\":\"2-3\"}"));
+	dlink_api = NULL;
+}
+END_TEST
+
+/// TEST CASE -> Engine API refuses request, or socket missing
+/// EXPECTED -> thread exits with failure, no fallback to CLI
+START_TEST(dockerlink_api_fail)
+{
+	pthread_t thread1;
+	int  iret1;
+	int * th_ret;
+
+	if (_i) // nobody listening
+		(void)unlink(dsrv.path + 7);
+	else {
+		dsrv.code = 404;
+		ck_assert_int_eq(0, pthread_create(&dsrv.thread, NULL, dockerlink_server, NULL));
+	}
+
+	iret1 = pthread_create( &thread1, NULL, dlink_thread_watch, (void*) dsrv.path);
+	ck_assert_int_eq(iret1, 0);
+
+	if (!iret1) // thread started successfully
+		iret1 = pthread_join( thread1, (void**)&th_ret); // wait until end
+	ck_assert_int_eq(EXIT_FAILURE, *th_ret);
+	ck_assert_int_eq(-1, dsock.fd);
+
+	if (!_i)
+		(void)pthread_join(dsrv.thread, NULL);
+}
+END_TEST
+
+/// TEST CASE -> fill event queue, overflow and drain in batches
+/// EXPECTED -> events in order, refused push counted, wrap around works
+START_TEST(dockerlink_queue)
+{
+	contevent_t evnt = { cnt_pending }, evnts[DLINK_RINGSZ];
+
+	for (int round = 0; round < 3; round++) {
+		for (int i = 0; i < DLINK_RINGSZ; i++) {
+			evnt.timenano = round * DLINK_RINGSZ + i;
+			ck_assert_int_eq(0, dlink_push(&evnt));
+		}
+		ck_assert_int_eq(round, dlink_overflow);
+		ck_assert_int_eq(-1, dlink_push(&evnt));
+		ck_assert_int_eq(round + 1, dlink_overflow);
+
+		int cnt = 0, got;
+		while ((got = dlink_pop(evnts + cnt, 10)))
+			cnt += got;
+		ck_assert_int_eq(DLINK_RINGSZ, cnt);
+		for (int i = 0; i < DLINK_RINGSZ; i++)
+			ck_assert_int_eq(round * DLINK_RINGSZ + i, evnts[i].timenano);
+	}
+}
+END_TEST
+
+#define DLINK_PRODUCERS	4
+#define DLINK_EVENTS	5000
+
+static void * dockerlink_producer(void * arg) {
+	contevent_t evnt = { (int)(intptr_t)arg };
+
+	for (int i = 0; i < DLINK_EVENTS; i++) {
+		evnt.timenano = i;
+		while (dlink_push(&evnt))
+			(void)sched_yield();
+	}
+	return NULL;
+}
+
+/// TEST CASE -> concurrent producers, one consumer
+/// EXPECTED -> all events received once, in order per producer
+START_TEST(dockerlink_queue_mp)
+{
+	pthread_t thread[DLINK_PRODUCERS];
+	uint64_t next[DLINK_PRODUCERS] = { 0 };
+	contevent_t evnts[16];
+	int cnt = 0;
+
+	for (intptr_t i = 0; i < DLINK_PRODUCERS; i++)
+		ck_assert_int_eq(0, pthread_create(&thread[i], NULL, dockerlink_producer, (void *)i));
+
+	while (cnt < DLINK_PRODUCERS * DLINK_EVENTS) {
+		int got = dlink_pop(evnts, 16);
+		for (int i = 0; i < got; i++) {
+			ck_assert_int_eq(next[evnts[i].event], evnts[i].timenano);
+			next[evnts[i].event]++;
+		}
+		cnt += got;
+	}
+
+	for (int i = 0; i < DLINK_PRODUCERS; i++)
+		(void)pthread_join(thread[i], NULL);
+	ck_assert_int_eq(0, dlink_pop(evnts, 16));
+}
+END_TEST
+
 /*
 static char * dockerlink_cevents [6] = {
 	"2019-07-22 14:59:10.335889938 +0000 UTC moby /containers/create {\"id\":\"4cf50eb963ca612f267cfb5890154afabcd1aa931d7e791f5cfee22bef698c29\",\"runtime\":{\"name\":\"io.containerd.runtime.v1.linux\",\"options\":{\"type_url\":\"containerd.linux.runc.RuncOptions\",\"value\":\"CgRydW5jEhwvdmFyL3J1bi9kb2NrZXIvcnVudGltZS1ydW5j\"}}}",
@@ -217,6 +496,8 @@ void library_dockerlink (Suite * s) {
 	tcase_add_loop_test(tc1, dockerlink_conf, 0, 6);
 	tcase_add_loop_test(tc1, dockerlink_conf_att, 0, 6);
 	tcase_add_test(tc1, dockerlink_conf_dmp);
+	tcase_add_test(tc1, dockerlink_conf_create);
+	tcase_add_test(tc1, dockerlink_tok);
 
     suite_add_tcase(s, tc1);
 
@@ -226,5 +507,19 @@ void library_dockerlink (Suite * s) {
 
 	suite_add_tcase(s, tc2);
 
+	TCase *tc3 = tcase_create("dockerlink_api");
+	tcase_add_checked_fixture(tc3, dockerlink_api_setup, dockerlink_api_teardown);
+	tcase_add_loop_test(tc3, dockerlink_api, 0, 4);
+	tcase_add_loop_test(tc3, dockerlink_api_fail, 0, 2);
+	tcase_add_loop_test(tc3, dockerlink_cpuset, 0, 2);
+
+	suite_add_tcase(s, tc3);
+
+	TCase *tc4 = tcase_create("dockerlink_queue");
+	tcase_add_test(tc4, dockerlink_queue);
+	tcase_add_test(tc4, dockerlink_queue_mp);
+
+	suite_add_tcase(s, tc4);
+
 	return;
 }
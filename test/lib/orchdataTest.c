@@ -235,6 +235,49 @@ START_TEST(orchdata_qsort3)
 }
 END_TEST
 
+/// TEST CASE -> add nodes to the PID index, find and remove them
+/// EXPECTED -> all indexed PIDs are found, popped or deactivated ones not
+START_TEST(orchdata_pidindex)
+{
+	const int cnt = 300; // forces table growth
+
+	ck_assert(!nhead);
+	ck_assert(!node_idxGet(1));
+
+	for (int i = 1; i <= cnt; i ++) {
+		node_push(&nhead);
+		nhead->pid = i * 7;
+		node_idxAdd(nhead);
+	}
+
+	for (node_t * curr = nhead; ((curr)); curr=curr->next)
+		ck_assert(curr == node_idxGet(curr->pid));
+	ck_assert(!node_idxGet(8));
+	ck_assert(!node_idxGet(0));
+	ck_assert(!node_idxGet(-7));
+
+	// deactivate, as with PID tracking
+	node_idxDel(nhead->next);
+	nhead->next->pid *= -1;
+	ck_assert(!node_idxGet(abs(nhead->next->pid)));
+
+	// pop removes from index, others remain reachable
+	int pid = nhead->pid;
+	node_pop(&nhead);
+	ck_assert(!node_idxGet(pid));
+	for (node_t * curr = nhead; ((curr)); curr=curr->next)
+		if (0 < curr->pid)
+			ck_assert(curr == node_idxGet(curr->pid));
+
+	// cleanup
+	while ((nhead))
+		node_pop(&nhead);
+	for (int i = 1; i <= cnt; i ++)
+		ck_assert(!node_idxGet(i * 7));
+	node_idxFree();
+}
+END_TEST
+
 
 /// Static setup for all tests in the following batch
 static void orchdata_setup() {
@@ -338,6 +381,7 @@ void library_orchdata (Suite * s) {
 	tcase_add_test(tc0, orchdata_qsort);
 	tcase_add_test(tc0, orchdata_qsort2);
 	tcase_add_test(tc0, orchdata_qsort3);
+	tcase_add_test(tc0, orchdata_pidindex);
     suite_add_tcase(s, tc0);
 
     // FIXME: copyresources tested in duplicateOrRefreshContainer
@@ -31,7 +31,8 @@ void buildEventConf(){
 	push((void**)&elist_head, sizeof(struct ftrace_elist));
 	elist_head->eventid = 317;	// used for kernel 4 and 6, may differ
 	elist_head->event = TR_EVENT_SWITCH;
-	elist_head->eventcall = pickPidInfoS;
+	elist_head->eventcall = pickPidInfoS_u;
+	(void)setEventCall(elist_head->eventid, elist_head->eventcall);
 }
 
 void clearEventConf(){
@@ -43,6 +44,9 @@ void clearEventConf(){
 		}
 		pop((void**)&elist_head);
 	}
+	free(elist_disp);
+	elist_disp = NULL;
+	elist_dispsz = 0;
 }
 
 static void orchestrator_manage_setup() {
@@ -62,6 +66,7 @@ static void orchestrator_manage_setup() {
 
 static void orchestrator_manage_teardown() {
 	// free memory
+	freeTracer(&rHead);
 	while (nhead)
 		node_pop(&nhead);
 	while (elist_thead)
@@ -170,7 +175,7 @@ START_TEST(orchestrator_manage_readftrace)
 	pthread_t thread1;
 	int  iret1;
 	struct ftrace_thread fthread;
-	fthread.dbgfile = malloc(MAX_PATH); // it's freed inside the thread
+	fthread.dbgfile = malloc(MAX_PATH); // owned by caller, freed after join
 	fthread.cpuno = 1; // dummy value
 	(void)sprintf(fthread.dbgfile, "test/resources/manage_ftread.dat"); // dump of a kernel thread scan
 
@@ -183,6 +188,7 @@ START_TEST(orchestrator_manage_readftrace)
 		node_push(&nhead);
 		nhead->pid = pid[i];
 		nhead->psig = strdup("");
+		node_idxAdd(nhead);
 	}
 
 	buildEventConf();
@@ -197,6 +203,7 @@ START_TEST(orchestrator_manage_readftrace)
 
 	if (!iret1) // thread started successfully
 		iret1 = pthread_join( thread1, NULL); // wait until end
+	free(fthread.dbgfile);
 
 	clearEventConf();
 
@@ -314,6 +321,10 @@ START_TEST(orchestrator_manage_ftrc_offsetparse)
 	ck_assert_ptr_eq((pid_t*)	0x38, tr_switch.next_pid);
 	ck_assert_ptr_eq((int32_t*)	0x3C, tr_switch.next_prio);
 
+	// known layout, packed view
+	ck_assert_int_eq(trl_std, tr_common_lay);
+	ck_assert_int_eq(trl_std, tr_switch_lay);
+
 	clearEventConf();
 
 	// format example 6.1
@@ -351,7 +362,89 @@ START_TEST(orchestrator_manage_ftrc_offsetparse)
 	ck_assert_ptr_eq((pid_t*)	0x40, tr_switch.next_pid);
 	ck_assert_ptr_eq((int32_t*)	0x44, tr_switch.next_prio);
 
+	// known layout, packed view with lazy preempt count
+	ck_assert_int_eq(trl_std, tr_common_lay);
+	ck_assert_int_eq(trl_rt, tr_switch_lay);
+
+	clearEventConf();
+}
+END_TEST
+
+/// TEST CASE -> read sched_switch fields through packed views and parsed offsets
+/// EXPECTED -> both give the same values, unknown layouts fall back to offsets
+START_TEST(orchestrator_manage_ftrc_views)
+{
+	const char * const fmts[] = { "6.5", "6.1", "6.5w", NULL };
+	const enum tr_layout lays[] = { trl_std, trl_rt, trl_offset };
+	char * buf = malloc(PIPE_BUFFER);
+
+	for (int i=0; (fmts[i]); i++){
+		char fn[MAX_PATH];
+		FILE *f;
+		int ret;
+
+		(void)sprintf(fn, "test/resources/manage_sched_switch_fmt%s.txt", fmts[i]);
+		if ((f = fopen (fn,"r"))) {
+			ret = fread(buf, sizeof(char), PIPE_BUFFER-1, f);
+			ck_assert_int_ne(ret, 0);
+			buf[ret] = '\0';
+			fclose(f);
+		}
+		else
+			ck_abort_msg("Could not open file: %s", strerror(errno));
+
+		buildEventConf();
+		parseEventFields (&elist_head->fields, buf);
+		(void)parseEventOffsets();
+		ck_assert_int_eq(lays[i], tr_switch_lay);
+
+		// event with values at parsed offsets
+		unsigned char event[128] = { 0 };
+		*(pid_t *)(event + (intptr_t)tr_switch.prev_pid) = 1234;
+		*(pid_t *)(event + (intptr_t)tr_switch.next_pid) = 4321;
+		*(int32_t *)(event + (intptr_t)tr_switch.next_prio) = 98;
+		(void)strcpy((char *)event + (intptr_t)tr_switch.next_comm, "next");
+
+		struct tr_switch_rec rec[2];
+		getSwitchRec(event, &rec[0]);
+		tr_switch_lay = trl_offset;
+		getSwitchRec(event, &rec[1]);
+
+		for (int j=0; j<2; j++){
+			ck_assert_int_eq(1234, rec[j].prev_pid);
+			ck_assert_int_eq(4321, rec[j].next_pid);
+			ck_assert_int_eq(98, rec[j].next_prio);
+			ck_assert_str_eq("next", rec[j].next_comm);
+		}
+
+		clearEventConf();
+	}
+	free(buf);
+}
+END_TEST
+
+/// TEST CASE -> register handlers in the event dispatch table
+/// EXPECTED -> table grows to highest ID, unset and invalid IDs are refused/skipped
+START_TEST(orchestrator_manage_ftrc_dispatch)
+{
+	buildEventConf();
+	ck_assert_int_eq(318, elist_dispsz);
+	ck_assert(pickPidInfoS_u == elist_disp[317]);
+	ck_assert(NULL == elist_disp[316]);
+
+	ck_assert_int_eq(0, setEventCall(320, pickPidInfoW_u));
+	ck_assert_int_eq(321, elist_dispsz);
+	ck_assert(pickPidInfoS_u == elist_disp[317]);
+	ck_assert(NULL == elist_disp[318]);
+	ck_assert(pickPidInfoW_u == elist_disp[320]);
+
+	ck_assert_int_eq(-1, setEventCall(-1, pickPidInfoW_u));
+	ck_assert_int_eq(-1, setEventCall(UINT16_MAX+1, pickPidInfoW_u));
+	ck_assert_int_eq(321, elist_dispsz);
+
 	clearEventConf();
+	ck_assert_ptr_null(elist_disp);
+	ck_assert_int_eq(0, elist_dispsz);
 }
 END_TEST
 
@@ -371,12 +464,13 @@ START_TEST(orchestrator_manage_ftrc_ppcmn)
 		char * name = malloc(16);
 		(void)sprintf(name, "PID %d", i);
 		nhead->psig = name;
+		node_idxAdd(nhead);
 	}
 
 	// Default common  - kernel 6.5
 	const struct tr_common tc_common_default = { (void *)0, (void *)2, (void *)3, (void *)4 };
 	tr_common = tc_common_default;
-	int ret = pickPidCommon(&frame, NULL, 0);
+	int ret = pickPidCommon_u(&frame, NULL, 0);
 
 	ck_assert_int_eq(0, ret);
 	ck_assert(!(nhead->status & MSK_STATNRSCH));
@@ -385,6 +479,195 @@ START_TEST(orchestrator_manage_ftrc_ppcmn)
 }
 END_TEST
 
+/// TEST CASE -> apply a batch of decoded events with one lock
+/// EXPECTED -> events are applied in order, a malformed event drops the rest
+START_TEST(orchestrator_manage_ftrc_batch)
+{
+	// Test frames  - kernel 6.5, PID 2, malformed, PID 3
+	unsigned char frame [3][8] = {	{0x00,0x00,0x00,0x00,0x02,0x00,0x00,0x00},
+									{0x00,0xF0,0x00,0x00,0x01,0x00,0x00,0x00},
+									{0x00,0x00,0x00,0x00,0x03,0x00,0x00,0x00} };
+
+	// Generate Nodes
+	const int pid[] = { 1, 2, 3	};
+
+	for (int i=0; i<sizeof(pid)/sizeof(int); ++i) {
+		node_push(&nhead);
+		nhead->pid = pid[i];
+		nhead->psig = strdup("");
+		node_idxAdd(nhead);
+	}
+
+	const struct tr_common tc_common_default = { (void *)0, (void *)2, (void *)3, (void *)4 };
+	tr_common = tc_common_default;
+
+	struct ftrace_bevent batch[3];
+	for (int i=0; i<3; i++){
+		batch[i].eventcall = pickPidCommon_u;
+		batch[i].addr = &frame[i];
+		batch[i].ts = i;
+	}
+
+	ck_assert_int_eq(0, applyEventBatch(batch, 1, NULL));
+	ck_assert(!(nhead->status & MSK_STATNRSCH));
+	ck_assert(nhead->next->status & MSK_STATNRSCH);
+
+	ck_assert_int_eq(-1, applyEventBatch(&batch[1], 2, NULL));
+	ck_assert(!(nhead->status & MSK_STATNRSCH));
+	ck_assert(!(nhead->next->next->status & MSK_STATNRSCH));
+}
+END_TEST
+
+/// TEST CASE -> compose kernel event filters from the tracked PID set
+/// EXPECTED -> consecutive PIDs merge to ranges, deactivated are skipped, overflow fails
+START_TEST(orchestrator_manage_ftrc_filter)
+{
+	struct tr_pidrange * rng = NULL;
+	int rngsz = 0;
+	char buf[128];
+
+	// empty set, nothing passes
+	ck_assert_int_eq(0, getPidRanges_u(&rng, &rngsz));
+	ck_assert_int_lt(0, getEventFilter(buf, sizeof(buf), tr_switch_flt, rng, 0));
+	ck_assert_str_eq("prev_pid<0", buf);
+
+	// Generate Nodes, list is descending
+	const int pid[] = { 2, -4, 5, 8, 9, 10 };
+
+	for (int i=0; i<sizeof(pid)/sizeof(int); ++i) {
+		node_push(&nhead);
+		nhead->pid = pid[i];
+		nhead->psig = strdup("");
+	}
+
+	int cnt = getPidRanges_u(&rng, &rngsz);
+	ck_assert_int_eq(3, cnt);
+	ck_assert_int_eq(8, rng[0].lo);
+	ck_assert_int_eq(10, rng[0].hi);
+	ck_assert_int_eq(5, rng[1].lo);
+	ck_assert_int_eq(5, rng[1].hi);
+	ck_assert_int_eq(2, rng[2].lo);
+
+	ck_assert_int_lt(0, getEventFilter(buf, sizeof(buf), tr_wakeup_flt, rng, cnt));
+	ck_assert_str_eq("(pid>=8&&pid<=10)||pid==5||pid==2", buf);
+
+	ck_assert_int_lt(0, getEventFilter(buf, sizeof(buf), tr_switch_flt, rng, cnt));
+	ck_assert_str_eq("(prev_pid>=8&&prev_pid<=10)||prev_pid==5||prev_pid==2"
+			"||(next_pid>=8&&next_pid<=10)||next_pid==5||next_pid==2", buf);
+
+	// does not fit
+	ck_assert_int_eq(-1, getEventFilter(buf, 32, tr_switch_flt, rng, cnt));
+
+	free(rng);
+}
+END_TEST
+
+/// TEST CASE -> adapt ring-buffer size to losses and fill level of a period
+/// EXPECTED -> doubles on loss up to limit, halves after quiet periods down to initial size
+START_TEST(orchestrator_manage_ftrc_bufsize)
+{
+	prgset->dryrun |= MSK_DRYNOTRCNG;	// do not touch kernel buffers
+	struct ftrace_thread fthread = { NULL, 0, 0, 0, NULL };
+	fthread.bufkb = fthread.bufmin = 1024;
+
+	// losses grow the buffer
+	fthread.missed = 5;
+	fthread.lossy = 1;
+	ck_assert_int_eq(0, updateTraceBuffer(&fthread));
+	ck_assert_int_eq(2048, fthread.bufkb);
+	ck_assert_int_eq(0, updateTraceBuffer(&fthread));
+	ck_assert_int_eq(2048, fthread.bufkb);	// no new loss, stays
+
+	fthread.bufkb = TR_BUFMAX_KB;
+	fthread.missed++;
+	ck_assert_int_eq(0, updateTraceBuffer(&fthread));
+	ck_assert_int_eq(TR_BUFMAX_KB, fthread.bufkb);
+
+	// high fill keeps size
+	fthread.bufkb = 2048;
+	for (int i=0; i<TR_BUFQUIET; i++){
+		fthread.pages += 2048 * 1024 / PIPE_BUFFER / 2;
+		ck_assert_int_eq(0, updateTraceBuffer(&fthread));
+	}
+	ck_assert_int_eq(2048, fthread.bufkb);
+
+	// quiet shrinks, not below initial size
+	for (int i=0; i<TR_BUFQUIET*2; i++)
+		ck_assert_int_eq(0, updateTraceBuffer(&fthread));
+	ck_assert_int_eq(1024, fthread.bufkb);
+	ck_assert_int_eq(0, fthread.bufquiet);
+
+	// fixed size is left alone
+	fthread.bufkb = -1;
+	fthread.missed++;
+	ck_assert_int_eq(0, updateTraceBuffer(&fthread));
+	ck_assert_int_eq(-1, fthread.bufkb);
+}
+END_TEST
+
+static void
+copyResource(const char * src, const char * dir, const char * name){
+	char buf[PIPE_BUFFER];
+	size_t len;
+	FILE * in = fopen(src, "r");
+	FILE * out = openTraceFile(dir, "w", "%s", name);
+	ck_assert_ptr_nonnull(in);
+	ck_assert_ptr_nonnull(out);
+	while ((len = fread(buf, 1, sizeof(buf), in)))
+		ck_assert_int_eq(len, fwrite(buf, 1, len, out));
+	fclose(in);
+	fclose(out);
+}
+
+/// TEST CASE -> replay a recorded trace page, events and formats from record
+/// EXPECTED -> events are set-up from record, readers advance in trace time and end
+START_TEST(orchestrator_manage_ftrc_replay)
+{
+	char dir[] = "/tmp/orchtest_XXXXXX";
+	ck_assert_ptr_nonnull(mkdtemp(dir));
+
+	FILE * f = openTraceFile(dir, "w", TR_REC_EVENTS);
+	ck_assert_ptr_nonnull(f);
+	(void)fprintf(f, "319 " TR_EVENT_SWITCH "\n1000 unknown/event\n");
+	fclose(f);
+	f = openTraceFile(dir, "w", TR_REC_CPUS);
+	ck_assert_ptr_nonnull(f);
+	(void)fprintf(f, "1\n");
+	fclose(f);
+	copyResource("test/resources/manage_sched_switch_fmt6.5.txt", dir, "319.format");
+	copyResource("test/resources/manage_ftread.dat", dir, "cpu1.raw");
+
+	prgset->trace_play = strdup(dir);
+	ftrace_stop = 0;
+
+	ck_assert_int_eq(0, configureTracers());
+	ck_assert_ptr_nonnull(elist_head);
+	ck_assert_ptr_null(elist_head->next);
+	ck_assert_int_eq(319, elist_head->eventid);
+	ck_assert(pickPidInfoS_u == elist_disp[319]);
+
+	ck_assert_int_eq(0, startTraceRead());
+	int32_t state = 1;
+	int cycles = 0;
+	while (!replayAdvance(&state))
+		cycles++;
+	ck_assert_int_eq(1, cycles);	// one page, start
+	ck_assert_int_ne(0, replay_limit);
+
+	ck_assert_int_eq(0, stopTraceRead());
+	resetTracers();
+	ck_assert_ptr_null(elist_head);
+
+	const char * const files[] = { TR_REC_EVENTS, TR_REC_CPUS, "319.format", "cpu1.raw", NULL };
+	for (const char * const * fn = files; (*fn); fn++){
+		char path[_POSIX_PATH_MAX];
+		(void)sprintf(path, "%s/%s", dir, *fn);
+		(void)unlink(path);
+	}
+	(void)rmdir(dir);
+}
+END_TEST
+
 /// TEST CASE -> pass a kernel tracer frame to pickPidSwitch and evaluates it
 /// EXPECTED -> corresponding nodes and data should change
 START_TEST(orchestrator_manage_ftrc_ppswitch)
@@ -404,6 +687,7 @@ START_TEST(orchestrator_manage_ftrc_ppswitch)
 		char * name = malloc(16);
 		(void)sprintf(name, "PID %d", (i+1));
 		nhead->psig = name;
+		node_idxAdd(nhead);
 	}
 
 	// Generate ftrace thread info
@@ -418,7 +702,7 @@ START_TEST(orchestrator_manage_ftrc_ppswitch)
 	frame[0x38]=3;
 
 	// TODOL modify to test sections of pickPidInfoS
-	int ret = pickPidInfoS(&frame, elist_thead, 0);
+	int ret = pickPidInfoS_u(&frame, elist_thead, 0);
 
 	ck_assert_int_eq(0, ret);
 	ck_assert(!(nhead->status & MSK_STATNRSCH));
@@ -480,17 +764,21 @@ START_TEST(orchestrator_manage_ppckbuf)
 	const int pid[] = { 1, 2, 3, 4, 5, 6};
 	int ret;
 
+	// one tracer per CPU, tasks are checked against their tracer only
+	numa_bitmask_setbit(prgset->affinity_mask, 1);
+	createResTracer();
+
 	for (int i=0; i<sizeof(pid)/sizeof(int); ++i) {
 		node_push(&nhead);
 		nhead->pid = pid[i];
 		char * name = malloc(16);
 		(void)sprintf(name, "PID %d", (i+1));
 		nhead->psig = name;
-		nhead->mon.assigned = i % 2;
 		nhead->attr.sched_policy = (0 == i)? SCHED_OTHER : SCHED_DEADLINE;
 		nhead->mon.deadline = 50000 + i * 10000;
 		nhead->attr.sched_period = 5000 + 5000 * (i % 3);
 		nhead->attr.sched_runtime = nhead->attr.sched_period / 5;
+		(void)assignPidCPU(nhead, i % 2);
 	}
 
 	ret = pickPidCheckBuffer(nhead->next, 60000, 1000);
@@ -500,6 +788,85 @@ START_TEST(orchestrator_manage_ppckbuf)
 	ret = pickPidCheckBuffer(nhead->next->next, 76000, 1000); // s
 	ck_assert_int_eq(1, ret);
 
+	// only tasks in the task list of the tracer are visited
+	node_trcDel(nhead->next->next->next->next);	// PID 2, CPU 1
+	ret = pickPidCheckBuffer(nhead->next->next, 76000, 1000);
+	ck_assert_int_eq(0, ret);
+
+}
+END_TEST
+
+/// TEST CASE -> Monte-Carlo bin-packing proposes container moves
+/// EXPECTED -> group moves off the overloaded CPU to where both stay below threshold
+START_TEST(orchestrator_manage_mcbin)
+{
+	node_t * item = NULL;
+	resTracer_t * ntrc = NULL;
+	rscs_t rscs = { -1 };
+	cont_t cont[2] = {{ 0 }};
+	pidc_t parm[2] = {{ .rscs = &rscs, .cont = &cont[0] }, { .rscs = &rscs, .cont = &cont[1] }};
+	const int cpu[] = { 1, 0, 0, 0 };
+	const uint64_t rt[] = { 500000, 450000, 300000, 300000 };
+
+	numa_bitmask_setbit(prgset->affinity_mask, 1);
+	createResTracer();
+
+	// CPU0: container 0 U=0.45, container 1 U=0.6, CPU1: single PID U=0.5
+	for (int i=0; i<sizeof(cpu)/sizeof(int); ++i) {
+		node_push(&nhead);
+		nhead->pid = 4-i;
+		nhead->attr.sched_policy = SCHED_FIFO;
+		nhead->mon.cdf_period = 1000000;
+		nhead->mon.cdf_runtime = rt[i];
+		nhead->param = (i) ? &parm[i/2] : NULL;
+		(void)assignPidCPU(nhead, cpu[i]);
+	}
+
+	// incremental, no samples without budget
+	ck_assert_int_eq(0, mcbinSnapshot_u());
+	ck_assert_int_eq(0, mcbinSample(0));
+	ck_assert_int_gt(MCBIN_SAMPLES, mcb.samples);
+
+	// container 1 would overload CPU1, container 0 fits
+	ck_assert_int_eq(0, mcbinSnapshot_u());
+	ck_assert_int_eq(1, mcbinSample(NSEC_PER_SEC));
+	ck_assert_int_eq(1, mcbinMove_u(&item, &ntrc));
+	ck_assert_ptr_eq(&cont[0], item->param->cont);
+	ck_assert_ptr_eq(getTracer(1), ntrc);
+	ck_assert_int_eq(0, mcb.samples);
+
+	// allocation changed while sampling, no move
+	ck_assert_int_eq(0, mcbinSnapshot_u());
+	ck_assert_int_eq(1, mcbinSample(NSEC_PER_SEC));
+	for (node_t * it = nhead; ((it)); it=it->next)
+		if (4 == it->pid)
+			(void)assignPidCPU(it, 0);
+	item = NULL;
+	ck_assert_int_eq(0, mcbinMove_u(&item, &ntrc));
+	ck_assert_ptr_eq(NULL, item);
+	ck_assert_int_eq(0, mcb.samples);
+
+	// move done, all below threshold
+	for (node_t * it = nhead; ((it)); it=it->next)
+		if ((4 == it->pid) || (it->param == &parm[0]))
+			(void)assignPidCPU(it, 1);
+	ck_assert_int_eq(0, mcbinSnapshot_u());
+	ck_assert_int_eq(1, mcbinSample(NSEC_PER_SEC));
+	ck_assert_int_eq(0, mcbinMove_u(&item, &ntrc));
+	ck_assert_ptr_eq(NULL, item);
+
+	// overload, but fixed affinity, nothing to move
+	for (node_t * it = nhead; ((it)); it=it->next)
+		(void)assignPidCPU(it, 0);
+	rscs.affinity = 0;
+	ck_assert_int_eq(0, mcbinSnapshot_u());
+	ck_assert_int_eq(1, mcbinSample(NSEC_PER_SEC));
+	ck_assert_int_eq(0, mcbinMove_u(&item, &ntrc));
+	ck_assert_ptr_eq(NULL, item);
+
+	while (nhead)
+		node_pop(&nhead);
+	mcbinFree();
 }
 END_TEST
 
@@ -525,19 +892,31 @@ void orchestrator_manage (Suite * s) {
 	TCase *tc3 = tcase_create("manage_ftrace_cfg");
 	tcase_add_loop_test(tc3, orchestrator_manage_ftrc_cfgread, 0, 3);
 	tcase_add_test(tc3, orchestrator_manage_ftrc_offsetparse);
+	tcase_add_test(tc3, orchestrator_manage_ftrc_views);
+	tcase_add_test(tc3, orchestrator_manage_ftrc_dispatch);
 	suite_add_tcase(s, tc3);
 
 	TCase *tc4 = tcase_create("manage_ftrace_pickpid");
 	tcase_add_checked_fixture(tc4, orchestrator_manage_setup, orchestrator_manage_teardown);
 	tcase_add_test(tc4, orchestrator_manage_ftrc_ppcmn);
 	tcase_add_test(tc4, orchestrator_manage_ftrc_ppswitch);
+	tcase_add_test(tc4, orchestrator_manage_ftrc_batch);
+	tcase_add_test(tc4, orchestrator_manage_ftrc_filter);
+	tcase_add_test(tc4, orchestrator_manage_ftrc_bufsize);
 	suite_add_tcase(s, tc4);
 
 	TCase *tc5 = tcase_create("manage_ftrace_pickpid_acc");
 	tcase_add_checked_fixture(tc5, orchestrator_manage_setup, orchestrator_manage_teardown);
 	tcase_add_test(tc5, orchestrator_manage_ppconsrt);
 	tcase_add_test(tc5, orchestrator_manage_ppckbuf);
+	tcase_add_test(tc5, orchestrator_manage_mcbin);
 	suite_add_tcase(s, tc5);
 
+	TCase *tc6 = tcase_create("manage_ftrace_replay");
+	tcase_add_checked_fixture(tc6, orchestrator_manage_setup, orchestrator_manage_teardown);
+	tcase_add_test(tc6, orchestrator_manage_ftrc_replay);
+	tcase_set_timeout(tc6, 10);
+	suite_add_tcase(s, tc6);
+
 	return;
 }
@@ -316,7 +316,7 @@ START_TEST(recomputeTimesTest)
 	for (int i = 0; i<8; i++){
 		push((void**)&nhead, sizeof(node_t));
 		nhead->attr = attr;
-		nhead->mon.assigned = 0;
+		ck_assert_int_eq(0, assignPidCPU(nhead, 0));
 	}
 	// check normal
 	ck_assert_int_eq(0, recomputeCPUTimes(0));
@@ -326,7 +326,7 @@ START_TEST(recomputeTimesTest)
 	attr.sched_period = 250000; // = 20% load
 	push((void**)&nhead, sizeof(node_t));
 	nhead->attr = attr;
-	nhead->mon.assigned = 0;
+	ck_assert_int_eq(-1, assignPidCPU(nhead, 0));
 
 	// check full
 	ck_assert_int_eq(-1, recomputeCPUTimes_u(0, NULL));
@@ -343,6 +343,183 @@ START_TEST(recomputeTimesTest)
 }
 END_TEST
 
+/// TEST CASE -> task accounting of a resource tracer on add, remove and change
+/// EXPECTED -> utilization follows the tasks without walking the PID list
+START_TEST(tracerTasksTest)
+{
+	createResTracer();
+
+	struct sched_attr attr = {SCHED_ATTR_SIZE, SCHED_DEADLINE,
+						0, 0, 0,
+						100000,
+						1000000,
+						1000000};
+	resTracer_t * ftrc = getTracer(0);
+
+	for (int i = 0; i<4; i++){
+		node_push(&nhead);
+		nhead->pid = i+1;
+		nhead->attr = attr;
+		ck_assert_int_eq(0, assignPidCPU(nhead, 0));
+		ck_assert_ptr_eq(ftrc, nhead->mon.trc);
+	}
+	ck_assert_double_eq_tol(ftrc->U, 0.4, 0.001);
+
+	// unknown CPU, not accounted
+	node_push(&nhead);
+	nhead->pid = 5;
+	nhead->attr = attr;
+	ck_assert_int_eq(-2, assignPidCPU(nhead, 3));
+	ck_assert_int_eq(3, nhead->mon.assigned);
+	ck_assert_ptr_eq(nhead->mon.trc, NULL);
+	ck_assert_double_eq_tol(ftrc->U, 0.4, 0.001);
+
+	// remove middle task, CPU number kept
+	node_t * item = nhead->next->next;
+	releasePidCPU(item);
+	ck_assert_ptr_eq(item->mon.trc, NULL);
+	ck_assert_int_eq(0, item->mon.assigned);
+	ck_assert_double_eq_tol(ftrc->U, 0.3, 0.001);
+
+	// change of WCET
+	nhead->next->attr.sched_runtime = 300000;
+	ck_assert_int_eq(0, updatePidTimes(nhead->next));
+	ck_assert_double_eq_tol(ftrc->U, 0.5, 0.001);
+	ck_assert_int_eq(-2, updatePidTimes(item));
+
+	// freed node leaves the list, times are recomputed on next use
+	node_pop(&nhead->next);
+	ck_assert(ftrc->status & MSK_STATTUPD);
+	ck_assert_int_eq(0, recomputeCPUTimes(0));
+	ck_assert_double_eq_tol(ftrc->U, 0.2, 0.001);
+	ck_assert(!(ftrc->status & MSK_STATTUPD));
+
+	// append after removal, then unassign
+	ck_assert_int_eq(0, assignPidCPU(item, 0));
+	ck_assert_double_eq_tol(ftrc->U, 0.3, 0.001);
+	ck_assert_int_eq(-2, assignPidCPU(item, -1));
+	ck_assert_double_eq_tol(ftrc->U, 0.2, 0.001);
+
+	while (nhead)
+		node_pop(&nhead);
+	ck_assert_ptr_eq(ftrc->tasks, NULL);
+	ck_assert_int_eq(0, recomputeCPUTimes(0));
+	ck_assert_double_eq_tol(ftrc->U, 0.0, 0.001);
+}
+END_TEST
+
+/// TEST CASE -> processor demand admission of deadline tasks
+/// EXPECTED -> constrained deadlines rejected if demand exceeds interval
+START_TEST(checkDemandTest)
+{
+	createResTracer();
+
+	struct sched_attr attr = {SCHED_ATTR_SIZE, SCHED_DEADLINE,
+						0, 0, 0,
+						400000,
+						1000000,
+						1000000};
+	resTracer_t * ftrc = getTracer(0);
+
+	node_push(&nhead);
+	nhead->pid = 1;
+	nhead->attr = attr;
+	ck_assert_int_eq(0, assignPidCPU(nhead, 0));
+	prgset->admission = ADM_DEMAND;
+
+	// implicit deadlines, same as utilization bound
+	ck_assert_int_eq(0, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+	attr.sched_runtime = 700000;
+	ck_assert_int_eq(-1, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+	ck_assert_int_eq(0, checkAdmission(ftrc, &attr, getTracerTasks, nhead));
+
+	// constrained deadlines, both due after 500us
+	attr.sched_runtime = 400000;
+	attr.sched_deadline = 500000;
+	nhead->attr = attr;
+	ck_assert_int_eq(0, updatePidTimes(nhead));
+	ck_assert_int_eq(-1, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+	attr.sched_runtime = 100000;
+	ck_assert_int_eq(0, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+
+	// measured run-time replaces the budget
+	nhead->mon.cdf_runtime = 450000;
+	ck_assert_int_eq(-1, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+	nhead->mon.cdf_runtime = 0;
+
+	// placement, utilization fits but demand does not
+	attr.sched_runtime = 400000;
+	ck_assert_ptr_eq(NULL, checkPeriod(&attr, -99, -1));
+	prgset->admission = ADM_RTA;
+	ck_assert_ptr_eq(ftrc, checkPeriod(&attr, -99, -1));
+	prgset->admission = ADM_DEMAND;
+	attr.sched_deadline = 1000000;
+	ck_assert_ptr_eq(ftrc, checkPeriod(&attr, -99, -1));
+
+	while (nhead)
+		node_pop(&nhead);
+}
+END_TEST
+
+/// TEST CASE -> response-time admission of fixed-priority tasks
+/// EXPECTED -> lower priority task rejected if it misses, despite utilization
+START_TEST(checkResponseTest)
+{
+	createResTracer();
+
+	struct sched_attr attr = {SCHED_ATTR_SIZE, SCHED_FIFO,
+						0, 0, 10,
+						600000,
+						0,
+						1500000};
+	resTracer_t * ftrc = getTracer(0);
+
+	// measured times of a high priority task
+	node_push(&nhead);
+	nhead->pid = 1;
+	nhead->attr.sched_policy = SCHED_FIFO;
+	nhead->attr.sched_priority = 50;
+	nhead->mon.cdf_runtime = 500000;
+	nhead->mon.cdf_period = 1010000;
+	ck_assert_int_eq(0, assignPidCPU(nhead, 0));
+	ck_assert_double_eq_tol(ftrc->U, 0.5, 0.001);
+
+	// U = 0.9 fits, but R = 1.6ms > 1.5ms
+	ck_assert_ptr_eq(ftrc, checkPeriod(&attr, -99, -1));
+	prgset->admission = ADM_RTA;
+	ck_assert_int_eq(-1, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+	ck_assert_ptr_eq(NULL, checkPeriod(&attr, -99, -1));
+	ck_assert_int_eq(0, checkAdmission(ftrc, &attr, getTracerTasks, nhead));
+
+	// shorter run-time, R = 0.9ms
+	attr.sched_runtime = 400000;
+	ck_assert_ptr_eq(ftrc, checkPeriod(&attr, -99, -1));
+
+	// higher priority candidate, existing task misses instead
+	attr.sched_priority = 90;
+	attr.sched_runtime = 600000;
+	ck_assert_int_eq(-1, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+
+	// deadline task interferes with all, including release jitter
+	attr = (struct sched_attr){SCHED_ATTR_SIZE, SCHED_DEADLINE,
+						0, 0, 0,
+						300000,
+						1000000,
+						1000000};
+	ck_assert_int_eq(-1, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+	attr.sched_deadline = 300000;
+	ck_assert_int_eq(0, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+
+	// non real-time tasks are not checked
+	attr.sched_policy = SCHED_OTHER;
+	attr.sched_runtime = 900000;
+	ck_assert_int_eq(0, checkAdmission(ftrc, &attr, getTracerTasks, NULL));
+
+	while (nhead)
+		node_pop(&nhead);
+}
+END_TEST
+
 static void tc5_setupUnchecked() {
 	contparm = malloc (sizeof(containers_t));
 	contparm->img = NULL; // locals are not initialized
@@ -740,6 +917,49 @@ START_TEST(findparams_link2Test)
 }
 END_TEST
 
+/// TEST CASE -> pre-place a created container from dockerlink data
+/// EXPECTED -> placed with dry-run, not placed without Engine API
+START_TEST(placeContainerTest)
+{
+	prgset = calloc (1, sizeof(prgset_t));
+	parse_config_set_default(prgset);
+	prgset->affinity = strdup("0");
+	prgset->affinity_mask = parse_cpumask(prgset->affinity);
+	prgset->use_cgroup = DM_CGRP;
+	createResTracer();
+
+	node_push(&nhead);
+	nhead->pid = 0;
+	nhead->psig = NULL;
+	nhead->contid = strdup("d7408531a3b4d7408531a3b4");
+	nhead->imgid  = strdup("51c3cc77fcf051c3cc77fcf0");
+
+	char affinity[CPUSTRLEN];
+	ck_assert_int_eq(0, getContainerPlacement(nhead, affinity));
+	ck_assert_ptr_nonnull(nhead->param);
+	ck_assert_str_eq("0", affinity);
+
+	// Engine API not connected
+	ck_assert_int_eq(-1, setContainerPlacement(nhead->contid, affinity));
+	ck_assert_int_eq(ENOTCONN, errno);
+
+	prgset->dryrun |= MSK_DRYNOAFTY;
+	ck_assert_int_eq(0, setContainerPlacement(nhead->contid, affinity));
+
+	// start reconciles with the configured mask
+	prgset->cpusetdfileprefix = strdup("/tmp/");
+	ck_assert_int_eq(0, setContainerAffinity(nhead));
+
+	free(nhead->param);
+	nhead->param = NULL;
+	node_pop(&nhead);
+
+	freeTracer(&rHead);
+	freePrgSet(prgset);
+	prgset = NULL;
+}
+END_TEST
+
 void orchestrator_resmgnt (Suite * s) {
 	TCase *tc1 = tcase_create("resmgnt_periodFitting");
 	tcase_add_test(tc1, checkValueTest);
@@ -760,6 +980,9 @@ void orchestrator_resmgnt (Suite * s) {
 	tcase_add_test(tc3, checkPeriod_RTest);
 	tcase_add_loop_test(tc3, findPeriodTest, 0, 6);
 	tcase_add_test(tc3, recomputeTimesTest);
+	tcase_add_test(tc3, tracerTasksTest);
+	tcase_add_test(tc3, checkDemandTest);
+	tcase_add_test(tc3, checkResponseTest);
 
     suite_add_tcase(s, tc3);
 
@@ -777,6 +1000,7 @@ void orchestrator_resmgnt (Suite * s) {
 	tcase_add_loop_test(tc5, findparamsFailTest, 0, 4);
 	tcase_add_test(tc5, findparams_linkTest);
 	tcase_add_test(tc5, findparams_link2Test);
+	tcase_add_test(tc5, placeContainerTest);
 
 	suite_add_tcase(s, tc5);
 
@@ -58,12 +58,17 @@ static void orchestrator_update_teardown() {
 	// free memory
 	while (nhead)
 		node_pop(&nhead);
+	freeContPids();
+	freePidWatches();
+	pidfdon = 0;
+	pidfdmax = PIDFD_MAXFDS;
+	freeScanStrs();
 
 	freePrgSet(prgset);
 	freeContParm(contparm);
 }
 
-/// TEST CASE -> test detected pid list using pid signture and ps
+/// TEST CASE -> test detected pid list using pid signture and /proc
 /// EXPECTED -> 3 elements detectes (and no leaks!)
 START_TEST(orchestrator_update_getpids)
 {
@@ -71,8 +76,6 @@ START_TEST(orchestrator_update_getpids)
 	pid_t pid1, pid2, pid3;
 	FILE * fd1, * fd2,  * fd3;
 
-	char pid[CMD_LEN];
-
 	// create pids
 	fd1 = popen2("sleep 4", "r", &pid1);
 	fd2 = popen2("sleep 2", "r", &pid2);
@@ -80,16 +83,11 @@ START_TEST(orchestrator_update_getpids)
 	// set detect mode to pid
 	free (prgset->cont_pidc);
 	prgset->cont_pidc = strdup("sleep");
-#ifdef BUSYBOX
-	(void)sprintf(pid, "| grep -E '%s'", prgset->cont_pidc);
-#else
-	(void)sprintf(pid, "-C %s", prgset->cont_pidc);
-#endif
 	usleep(1000); // wait for process creation // yield
 
 	selectUpdate();
 
-	getPids(&nhead, pid, NULL);
+	getPids(&nhead, prgset->cont_pidc, NULL, 0, 0);
 
 	// verify 2 nodes exist
 	ck_assert(nhead);
@@ -101,6 +99,11 @@ START_TEST(orchestrator_update_getpids)
 	ck_assert_int_eq(nhead->next->next->pid, pid1);
 	ck_assert_int_eq(nhead->next->pid, pid2);
 	ck_assert_int_eq(nhead->pid, pid3);
+	ck_assert_str_eq("sleep 5", nhead->psig);
+
+	// strings are borrowed from the scan
+	while (nhead)
+		popScanPid(&nhead);
 
 	pclose2(fd1, pid1, SIGINT); // close pipe
 	pclose2(fd2, pid2, SIGINT); // close pipe
@@ -108,6 +111,42 @@ START_TEST(orchestrator_update_getpids)
 }
 END_TEST
 
+/// TEST CASE -> test detected pid list by parent name, as shim PPID mode
+/// EXPECTED -> children of the test process are found, and marked siblings
+START_TEST(orchestrator_update_getppids)
+{
+	pid_t pid1, pid2;
+	FILE * fd1, * fd2;
+	char comm[32];
+
+	fd1 = popen2("sleep 4", "r", &pid1);
+	fd2 = popen2("sleep 2", "r", &pid2);
+	usleep(1000); // wait for process creation // yield
+
+	// we are the parent
+	ck_assert_int_lt(0, getkernvar("/proc/self/", "comm", comm, sizeof(comm)));
+	free (prgset->cont_ppidc);
+	prgset->cont_ppidc = strdup(comm);
+
+	getParentPids(&nhead);
+
+	int found = 0;
+	for (node_t * item = nhead; ((item)); item=item->next)
+		if (pid1 == item->pid || pid2 == item->pid){
+			ck_assert(item->status & MSK_STATSIBL);
+			found++;
+		}
+	ck_assert_int_eq(2, found);
+
+	// strings are borrowed from the scan
+	while (nhead)
+		popScanPid(&nhead);
+
+	pclose2(fd1, pid1, SIGINT); // close pipe
+	pclose2(fd2, pid2, SIGINT); // close pipe
+}
+END_TEST
+
 /// TEST CASE -> test insert/remove from list
 /// EXPECTED -> 3 elements detected, than 1 removes, than 1 inserted
 START_TEST(orchestrator_update_scannew)
@@ -173,21 +212,395 @@ START_TEST(orchestrator_update_scannew)
 }
 END_TEST
 
+/// TEST CASE -> feed process connector events for exec and exit
+/// EXPECTED -> matching PID inserted in order with latency, then removed
+START_TEST(orchestrator_update_procevents)
+{
+	pid_t pid1, pid2;
+	FILE * fd1, * fd2;
+	struct proc_event ev = { 0 };
+	struct timespec now;
+
+	fd1 = popen2("sleep 4", "r", &pid1);
+	fd2 = popen2("sleep 2", "r", &pid2);
+	// set detect mode to pid
+	free (prgset->cont_pidc);
+	prgset->cont_pidc = strdup("sleep");
+	prgset->use_cgroup = DM_CMDLINE;
+
+	selectUpdate();
+
+	usleep(10000); // wait for process creation and exec // yield
+	scanNew();
+	pclose2(fd2, pid2, SIGINT);
+	scanNew();
+
+	ck_assert(nhead);
+	ck_assert(!nhead->next);
+	ck_assert_int_eq(nhead->pid, pid1);
+
+	// not matching, ignored
+	(void)memset(&proclat, 0, sizeof(proclat));
+	ev.what = PROC_EVENT_EXEC;
+	ev.event_data.exec.process_pid = getpid();
+	ev.event_data.exec.process_tgid = getpid();
+	ck_assert_int_eq(0, handleProcEvent(&ev));
+	ck_assert(!nhead->next);
+
+	// matching, inserted in order
+	fd2 = popen2("sleep 3", "r", &pid2);
+	usleep(10000); // wait for process creation and exec // yield
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &now);
+	ev.timestamp_ns = (uint64_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+	ev.event_data.exec.process_pid = pid2;
+	ev.event_data.exec.process_tgid = pid2;
+	ck_assert_int_eq(1, handleProcEvent(&ev));
+	ck_assert_int_eq(0, handleProcEvent(&ev)); // duplicate
+
+	ck_assert(nhead->next);
+	ck_assert_int_eq(nhead->pid, pid2);
+	ck_assert_int_eq(nhead->next->pid, pid1);
+	ck_assert_str_eq("sleep 3", nhead->psig);
+	ck_assert_int_eq(1, proclat.cnt);
+	ck_assert(proclat.max);
+
+	// exit
+	ev.what = PROC_EVENT_EXIT;
+	ev.event_data.exit.process_pid = pid2;
+	ev.event_data.exit.process_tgid = pid2;
+	ck_assert_int_eq(0, handleProcEvent(&ev));
+	ck_assert(!nhead->next);
+	ck_assert_int_eq(nhead->pid, pid1);
+
+	pclose2(fd1, pid1, SIGINT); // close pipe
+	pclose2(fd2, pid2, SIGINT); // close pipe
+}
+END_TEST
+
+/// TEST CASE -> exit of a managed PID through its pidfd
+/// EXPECTED -> PID removed on poll, without a scan
+START_TEST(orchestrator_update_pidfds)
+{
+	pid_t pid1, pid2;
+	FILE * fd1, * fd2;
+
+	fd1 = popen2("sleep 4", "r", &pid1);
+	fd2 = popen2("sleep 2", "r", &pid2);
+	// set detect mode to pid
+	free (prgset->cont_pidc);
+	prgset->cont_pidc = strdup("sleep");
+	prgset->use_cgroup = DM_CMDLINE;
+	pidfdon = 1;
+
+	selectUpdate();
+
+	usleep(10000); // wait for process creation and exec // yield
+	scanNew();
+
+	ck_assert(nhead);
+	ck_assert(nhead->next);
+	if (!pidfdon){ // ENOSYS, kernel too old
+		pclose2(fd1, pid1, SIGINT);
+		pclose2(fd2, pid2, SIGINT);
+		return;
+	}
+	ck_assert_int_eq(2, pidfdcnt);
+
+	// nothing happened
+	ck_assert_int_eq(0, pollEvents(&(struct timespec){ 0 }));
+	ck_assert(nhead->next);
+
+	pclose2(fd2, pid2, SIGINT);
+	ck_assert_int_eq(0, pollEvents(&(struct timespec){ 1, 0 }));
+
+	ck_assert(nhead);
+	ck_assert(!nhead->next);
+	ck_assert_int_eq(nhead->pid, pid1);
+	ck_assert_int_eq(1, pidfdcnt);
+
+	pclose2(fd1, pid1, SIGINT); // close pipe
+}
+END_TEST
+
+/// TEST CASE -> more managed PIDs than pidfds allowed
+/// EXPECTED -> PIDs above the cap unwatched, scans until they exit
+START_TEST(orchestrator_update_pidfdcap)
+{
+	pid_t pid1, pid2;
+	FILE * fd1, * fd2;
+
+	fd1 = popen2("sleep 4", "r", &pid1);
+	fd2 = popen2("sleep 2", "r", &pid2);
+	// set detect mode to pid
+	free (prgset->cont_pidc);
+	prgset->cont_pidc = strdup("sleep");
+	prgset->use_cgroup = DM_CMDLINE;
+	pidfdon = 1;
+	pidfdmax = 1;
+
+	selectUpdate();
+
+	usleep(10000); // wait for process creation and exec // yield
+	scanNew();
+
+	ck_assert(nhead);
+	ck_assert(nhead->next);
+	if (!pidfdon){ // ENOSYS, kernel too old
+		pclose2(fd1, pid1, SIGINT);
+		pclose2(fd2, pid2, SIGINT);
+		return;
+	}
+	ck_assert_int_eq(1, pidfdcnt);
+	ck_assert_int_eq(1, pidfdmiss);
+
+	pclose2(fd2, pid2, SIGINT);
+	pclose2(fd1, pid1, SIGINT);
+	usleep(10000);
+	(void)pollEvents(&(struct timespec){ 0 });
+	scanNew();
+
+	ck_assert(!nhead);
+	ck_assert_int_eq(0, pidfdcnt);
+	ck_assert_int_eq(0, pidfdmiss);
+}
+END_TEST
+
+#ifdef CGROUP2
+	#define TEST_CONTDIR(id) "docker-" id ".scope"
+#else
+	#define TEST_CONTDIR(id) id
+#endif
+#define TEST_CONTID1 "6b2b6d6a1a6bc6fa5f7a4d57b2c8b0b1e7d4b9a3e0f1c2d3e4f5a6b7c8d9e0f1"
+#define TEST_CONTID2 "0a1b2c3d4e5f60718293a4b5c6d7e8f90a1b2c3d4e5f60718293a4b5c6d7e8f9"
+
+/// test helper, write a file of a fake container CGroup
+static void
+writeContFile(const char * dir, const char * cont, const char * file, const char * value) {
+	char fname[_POSIX_PATH_MAX];
+	ck_assert_int_gt(sizeof(fname), snprintf(fname, sizeof(fname), "%s%s/%s", dir, cont, file));
+	FILE * f = fopen(fname, "w");
+	ck_assert(f);
+	(void)fputs(value, f);
+	(void)fclose(f);
+}
+
+/// TEST CASE -> read container PIDs from a fake CGroup tree, with cache
+/// EXPECTED -> cached with process events only, re-read on events
+START_TEST(orchestrator_update_contpids)
+{
+	char tmpl[] = "/tmp/orchXXXXXX";
+	char dir[_POSIX_PATH_MAX], path[_POSIX_PATH_MAX], pids[32];
+	node_t * lst = NULL;
+
+	ck_assert(mkdtemp(tmpl));
+	ck_assert_int_gt(sizeof(dir), snprintf(dir, sizeof(dir), "%s/", tmpl));
+	free(prgset->cpusetdfileprefix);
+	prgset->cpusetdfileprefix = strdup(dir);
+
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s" TEST_CONTDIR(TEST_CONTID1), dir));
+	ck_assert_int_eq(0, mkdir(path, 0755));
+	(void)sprintf(pids, "%d\n", getpid());
+	writeContFile(dir, TEST_CONTDIR(TEST_CONTID1), CGRP_PIDS, pids);
+	writeContFile(dir, TEST_CONTDIR(TEST_CONTID1), CGRP_EVTS, "populated 1\n");
+
+	prgset->use_cgroup = DM_CGRP;
+	selectUpdate();
+
+	getContPids(&lst);
+	ck_assert(lst);
+	ck_assert(!lst->next);
+	ck_assert_int_eq(getpid(), lst->pid);
+	ck_assert_str_eq(TEST_CONTID1, lst->contid);
+	ck_assert(!(lst->status & MSK_STATSIBL));
+	while (lst)
+		popScanPid(&lst);
+
+	// tasks changed without notification, cached list with process events
+	procfd = STDIN_FILENO; // not read by the scan
+	(void)sprintf(pids, "%d\n%d\n", getpid(), getppid());
+	writeContFile(dir, TEST_CONTDIR(TEST_CONTID1), CGRP_PIDS, pids);
+	getContPids(&lst);
+	ck_assert(lst);
+	ck_assert(!lst->next);
+	while (lst)
+		popScanPid(&lst);
+
+	// events file changed, read again
+	writeContFile(dir, TEST_CONTDIR(TEST_CONTID1), CGRP_EVTS, "populated 1\n");
+	getContPids(&lst);
+	ck_assert(lst);
+	ck_assert(lst->next);
+	ck_assert(!lst->next->next);
+	ck_assert(lst->status & MSK_STATSIBL);
+	while (lst)
+		popScanPid(&lst);
+
+	// new container
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s" TEST_CONTDIR(TEST_CONTID2), dir));
+	ck_assert_int_eq(0, mkdir(path, 0755));
+	(void)sprintf(pids, "%d\n", getpid());
+	writeContFile(dir, TEST_CONTDIR(TEST_CONTID2), CGRP_PIDS, pids);
+	writeContFile(dir, TEST_CONTDIR(TEST_CONTID2), CGRP_EVTS, "populated 1\n");
+	getContPids(&lst);
+	ck_assert(lst);
+	ck_assert(lst->next);
+	ck_assert(lst->next->next);
+	ck_assert(!lst->next->next->next);
+	while (lst)
+		popScanPid(&lst);
+
+	// removed container, tasks read every scan without process events
+	procfd = -1;
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s" TEST_CONTDIR(TEST_CONTID2) "/" CGRP_PIDS, dir));
+	ck_assert_int_eq(0, unlink(path));
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s" TEST_CONTDIR(TEST_CONTID2) "/" CGRP_EVTS, dir));
+	ck_assert_int_eq(0, unlink(path));
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s" TEST_CONTDIR(TEST_CONTID2), dir));
+	ck_assert_int_eq(0, rmdir(path));
+	(void)sprintf(pids, "%d\n", getpid());
+	writeContFile(dir, TEST_CONTDIR(TEST_CONTID1), CGRP_PIDS, pids);
+	getContPids(&lst);
+	ck_assert(lst);
+	ck_assert(!lst->next);
+	ck_assert_str_eq(TEST_CONTID1, lst->contid);
+	while (lst)
+		popScanPid(&lst);
+
+	freeContPids();
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s" TEST_CONTDIR(TEST_CONTID1) "/" CGRP_PIDS, dir));
+	(void)unlink(path);
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s" TEST_CONTDIR(TEST_CONTID1) "/" CGRP_EVTS, dir));
+	(void)unlink(path);
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s" TEST_CONTDIR(TEST_CONTID1), dir));
+	(void)rmdir(path);
+	(void)rmdir(tmpl);
+}
+END_TEST
+
+/// TEST CASE -> intern strings found by the scans
+/// EXPECTED -> same copy while in use, dropped after a scan without it
+START_TEST(orchestrator_update_scanstrs)
+{
+	char buf[20];
+	char * a = internScanStr("sleep 5");
+	char * b = internScanStr("sleep 6");
+
+	ck_assert_str_eq("sleep 5", a);
+	ck_assert_ptr_ne(a, b);
+	(void)snprintf(buf, sizeof(buf), "sleep %d", 5);
+	ck_assert_ptr_eq(a, internScanStr(buf));
+
+	// fill past the initial table size, forces rehash
+	for (int i = 0; i < 1000; i++) {
+		(void)snprintf(buf, sizeof(buf), "cmd %d", i);
+		(void)internScanStr(buf);
+	}
+	ck_assert_int_eq(1002, scanstrcnt);
+	ck_assert_ptr_eq(a, internScanStr("sleep 5"));
+
+	// next scan uses only "sleep 5", the others go
+	sweepScanStrs();
+	ck_assert_ptr_eq(a, internScanStr("sleep 5"));
+	sweepScanStrs();
+	ck_assert_int_eq(1, scanstrcnt);
+	ck_assert_ptr_eq(a, internScanStr("sleep 5"));
+}
+END_TEST
+
+/// TEST CASE -> record tracked PIDs and their exits, replay them
+/// EXPECTED -> replayed list follows the record up to the trace time
+START_TEST(orchestrator_update_pidrecord)
+{
+	char dir[] = "/tmp/orchtest_XXXXXX";
+	char path[_POSIX_PATH_MAX];
+	node_t * lst = NULL;
+
+	ck_assert_ptr_nonnull(mkdtemp(dir));
+	prgset->trace_rec = strdup(dir);
+
+	// buffered until written, trace not started
+	openPidRecord();
+	ck_assert_ptr_nonnull(pidrec);
+	node_push(&lst);
+	lst->pid = 10;
+	lst->psig = strdup("sleep 5");
+	recordPid(lst);
+	lst->pid = 11;
+	recordPid(lst);
+	recordPidExit(10);
+	recordPidExit(-11);	// deactivated, gone already
+	ck_assert_int_lt(0, pidreclen);
+	writePidRecord();
+	ck_assert_int_eq(0, pidreclen);
+	closePidRecord();
+	ck_assert_ptr_null(pidrec);
+	node_pop(&lst);
+
+	// a later record, ahead of the replay
+	ck_assert_int_gt(sizeof(path), snprintf(path, sizeof(path), "%s/" TR_REC_PIDS, dir));
+	FILE * f = fopen(path, "a");
+	ck_assert_ptr_nonnull(f);
+	(void)fputs("5 + 12 - - sleep 6\n", f);
+	(void)fclose(f);
+
+	free(prgset->trace_rec);
+	prgset->trace_rec = NULL;
+	prgset->trace_play = strdup(dir);
+
+	getReplayPids(&lst);
+	ck_assert_ptr_nonnull(lst);
+	ck_assert_ptr_null(lst->next);
+	ck_assert_int_eq(11, lst->pid);
+	ck_assert_str_eq("sleep 5", lst->psig);
+	ck_assert_int_eq(1, pidplaypend);
+	while (lst)
+		popScanPid(&lst);
+
+	freeReplayPids();
+	free(prgset->trace_play);
+	prgset->trace_play = NULL;
+	(void)unlink(path);
+	(void)rmdir(dir);
+}
+END_TEST
+
 /// TEST CASE -> fill link event structure and test passing/parameters
 /// EXPECTED ->  resources set and all freed
 START_TEST(orchestrator_update_dlinkread)
 {
-	containerEvent = malloc (sizeof (struct cont_event));
-	containerEvent->event = cnt_add;
-	containerEvent->id = strdup("1232144314");
-	containerEvent->name = strdup("testcont");
-	containerEvent->image = strdup("testimg");
+	contevent_t evnt = { cnt_add };
+	evnt.id = strdup("1232144314");
+	evnt.name = strdup("testcont");
+	evnt.image = strdup("testimg");
+	ck_assert_int_eq(0, dlink_push(&evnt));
 
 	selectUpdate();
 	updateDocker();
 
     // TODO: expand -- use existing id
 	ck_assert_ptr_null(contparm->cont);
+	ck_assert_int_eq(0, dlink_pop(&evnt, 1));
+}
+END_TEST
+
+/// TEST CASE -> burst of container starts and stops
+/// EXPECTED -> all events consumed in one update, none lost
+START_TEST(orchestrator_update_dlinkburst)
+{
+	char id[20];
+
+	for (int i = 0; i < 50; i++) {
+		(void)sprintf(id, "%d", 1232144314 + i);
+		contevent_t evnt = { (i % 2) ? cnt_remove : cnt_add, strdup("testcont"), strdup(id), strdup("testimg"), i };
+		ck_assert_int_eq(0, dlink_push(&evnt));
+	}
+
+	selectUpdate();
+	updateDocker();
+
+	ck_assert_int_eq(0, dlink_overflow);
+	ck_assert_int_eq(0, dlink_pop(&(contevent_t){ 0 }, 1));
 }
 END_TEST
 
@@ -426,9 +839,16 @@ void orchestrator_update (Suite * s) {
 	TCase *tc1 = tcase_create("update_newread");
 	tcase_add_checked_fixture(tc1, orchestrator_update_setup, orchestrator_update_teardown);
 	tcase_add_test(tc1, orchestrator_update_getpids);
-//	TODO: add examples getpPids
+	tcase_add_test(tc1, orchestrator_update_getppids);
 	tcase_add_test(tc1, orchestrator_update_scannew);
+	tcase_add_test(tc1, orchestrator_update_procevents);
+	tcase_add_test(tc1, orchestrator_update_contpids);
+	tcase_add_test(tc1, orchestrator_update_pidfds);
+	tcase_add_test(tc1, orchestrator_update_pidfdcap);
+	tcase_add_test(tc1, orchestrator_update_scanstrs);
+	tcase_add_test(tc1, orchestrator_update_pidrecord);
 	tcase_add_test(tc1, orchestrator_update_dlinkread);
+	tcase_add_test(tc1, orchestrator_update_dlinkburst);
 
 	suite_add_tcase(s, tc1);
 